@@ -0,0 +1,168 @@
+/**
+ * @file    benchmarkIdLookup.cpp
+ * @brief   Times id look-ups on large synthetic models
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This sample program is distributed under a different license than the rest
+ * of libSBML.  This program uses the open-source MIT license, as follows:
+ *
+ * Copyright (c) 2013-2018 by the California Institute of Technology
+ * (California, USA), the European Bioinformatics Institute (EMBL-EBI, UK)
+ * and the University of Heidelberg (Germany), with support from the National
+ * Institutes of Health (USA) under grant R01GM070923.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Neither the name of the California Institute of Technology (Caltech), nor
+ * of the European Bioinformatics Institute (EMBL-EBI), nor of the University
+ * of Heidelberg, nor the names of any contributors, may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * ------------------------------------------------------------------------ -->
+ */
+
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <sbml/SBMLTypes.h>
+#include "util.h"
+
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+BEGIN_C_DECLS
+
+/*
+ * Creates a model with the given number of species and as many reactions.
+ */
+static SBMLDocument*
+createModel (unsigned int size, vector<string>& ids)
+{
+  SBMLDocument* document = new SBMLDocument(3, 1);
+  Model* model = document->createModel();
+
+  Compartment* c = model->createCompartment();
+  c->setId("cell");
+  c->setConstant(true);
+
+  for (unsigned int n = 0; n < size; ++n)
+  {
+    ostringstream sid, rid;
+    sid << "S" << n;
+    rid << "R" << n;
+
+    Species* s = model->createSpecies();
+    s->setId(sid.str());
+    s->setCompartment("cell");
+    s->setHasOnlySubstanceUnits(false);
+    s->setBoundaryCondition(false);
+    s->setConstant(false);
+
+    Reaction* r = model->createReaction();
+    r->setId(rid.str());
+    r->setReversible(false);
+    r->setFast(false);
+
+    // resolving the reactant while building is what made this quadratic
+    SpeciesReference* sr = r->createReactant();
+    sr->setSpecies(model->getSpecies(sid.str())->getId());
+    sr->setConstant(true);
+
+    ids.push_back(sid.str());
+    ids.push_back(rid.str());
+  }
+
+  return document;
+}
+
+
+int
+main (int argc, char* argv[])
+{
+  unsigned int lookups = 1000000;
+  unsigned int sizes[] = { 1000, 10000, 100000 };
+
+  if (argc > 1)
+  {
+    istringstream(argv[1]) >> lookups;
+  }
+
+  cout << endl;
+  cout << "  elements   build (ms)   getSpecies/getReaction (ns)   getElementBySId (ns)"
+       << endl;
+
+  for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+  {
+    vector<string> ids;
+#ifdef __BORLANDC__
+    unsigned long start, stop;
+#else
+    unsigned long long start, stop;
+#endif
+
+    start = getCurrentMillis();
+    SBMLDocument* document = createModel(sizes[i], ids);
+    stop  = getCurrentMillis();
+    unsigned long long build = stop - start;
+
+    Model* model = document->getModel();
+    unsigned int found = 0;
+
+    start = getCurrentMillis();
+    for (unsigned int n = 0; n < lookups; ++n)
+    {
+      const string& id = ids[(n * 7919u) % ids.size()];
+      if (id[0] == 'S')
+        found += (model->getSpecies(id) != NULL);
+      else
+        found += (model->getReaction(id) != NULL);
+    }
+    stop = getCurrentMillis();
+    double typed = (stop - start) * 1.0e6 / lookups;
+
+    start = getCurrentMillis();
+    for (unsigned int n = 0; n < lookups; ++n)
+    {
+      found += (model->getElementBySId(ids[(n * 7919u) % ids.size()]) != NULL);
+    }
+    stop = getCurrentMillis();
+    double generic = (stop - start) * 1.0e6 / lookups;
+
+    cout << "  " << 2 * sizes[i] << "\t" << build << "\t\t" << typed
+         << "\t\t\t\t" << generic << endl;
+
+    if (found != 2 * lookups)
+    {
+      cerr << "lookup failed" << endl;
+      delete document;
+      return 1;
+    }
+
+    delete document;
+  }
+
+  cout << endl;
+  return 0;
+}
+
+END_C_DECLS
@@ -0,0 +1,222 @@
+/**
+ * @file    benchmarkValidation.cpp
+ * @brief   Times SBMLDocument::checkConsistency() with several threads
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This sample program is distributed under a different license than the rest
+ * of libSBML.  This program uses the open-source MIT license, as follows:
+ *
+ * Copyright (c) 2013-2018 by the California Institute of Technology
+ * (California, USA), the European Bioinformatics Institute (EMBL-EBI, UK)
+ * and the University of Heidelberg (Germany), with support from the National
+ * Institutes of Health (USA) under grant R01GM070923.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Neither the name of the California Institute of Technology (Caltech), nor
+ * of the European Bioinformatics Institute (EMBL-EBI), nor of the University
+ * of Heidelberg, nor the names of any contributors, may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * ------------------------------------------------------------------------ -->
+ */
+
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <sbml/SBMLTypes.h>
+#include "util.h"
+
+#if !defined(WIN32) || defined(CYGWIN)
+#include <sys/resource.h>
+#endif
+
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+BEGIN_C_DECLS
+
+/*
+ * Returns the peak resident set size of this process in kilobytes, or 0
+ * where it cannot be determined.
+ */
+static long
+getPeakRSS ()
+{
+#if !defined(WIN32) || defined(CYGWIN)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+  {
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+  }
+#endif
+  return 0;
+}
+
+
+/*
+ * Returns the text of a model with the given number of reactions, each
+ * with a reversible Michaelis-Menten style kinetic law.
+ */
+static string
+createModel (unsigned int size)
+{
+  ostringstream out;
+
+  out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      << "<sbml xmlns=\"http://www.sbml.org/sbml/level3/version1/core\""
+      << " level=\"3\" version=\"1\">\n"
+      << "<model id=\"math\">\n"
+      << "<listOfCompartments>\n"
+      << "<compartment id=\"cell\" size=\"1\" constant=\"true\"/>\n"
+      << "</listOfCompartments>\n"
+      << "<listOfSpecies>\n";
+
+  for (unsigned int n = 0; n <= size; ++n)
+  {
+    out << "<species id=\"S" << n << "\" compartment=\"cell\""
+        << " initialConcentration=\"1\" hasOnlySubstanceUnits=\"false\""
+        << " boundaryCondition=\"false\" constant=\"false\"/>\n";
+  }
+
+  out << "</listOfSpecies>\n"
+      << "<listOfParameters>\n"
+      << "<parameter id=\"Vf\" value=\"1\" constant=\"true\"/>\n"
+      << "<parameter id=\"Vr\" value=\"0.5\" constant=\"true\"/>\n"
+      << "<parameter id=\"Km\" value=\"0.1\" constant=\"true\"/>\n"
+      << "</listOfParameters>\n"
+      << "<listOfReactions>\n";
+
+  for (unsigned int n = 0; n < size; ++n)
+  {
+    out << "<reaction id=\"R" << n << "\" reversible=\"true\" fast=\"false\">\n"
+        << "<listOfReactants><speciesReference species=\"S" << n
+        << "\" stoichiometry=\"1\" constant=\"true\"/></listOfReactants>\n"
+        << "<listOfProducts><speciesReference species=\"S" << n + 1
+        << "\" stoichiometry=\"1\" constant=\"true\"/></listOfProducts>\n"
+        << "<kineticLaw><math xmlns=\"http://www.w3.org/1998/Math/MathML\">"
+        << "<apply><times/><ci>cell</ci><apply><divide/><apply><minus/>"
+        << "<apply><times/><ci>Vf</ci><ci>S" << n << "</ci></apply>"
+        << "<apply><times/><ci>Vr</ci><ci>S" << n + 1 << "</ci></apply>"
+        << "</apply><apply><plus/><ci>Km</ci><ci>S" << n << "</ci>"
+        << "<apply><power/><ci>S" << n + 1 << "</ci><cn type=\"integer\">2</cn>"
+        << "</apply></apply></apply></apply></math></kineticLaw>\n"
+        << "</reaction>\n";
+  }
+
+  out << "</listOfReactions>\n"
+      << "</model>\n"
+      << "</sbml>\n";
+
+  return out.str();
+}
+
+
+/*
+ * Returns the number of nodes in the tree rooted at the given node.
+ */
+static unsigned long
+countNodes (const ASTNode* node)
+{
+  unsigned long count = 1;
+  for (unsigned int c = 0; c < node->getNumChildren(); ++c)
+  {
+    count += countNodes(node->getChild(c));
+  }
+  return count;
+}
+
+
+int
+main (int argc, char* argv[])
+{
+  unsigned int size = 50000;
+  unsigned int repeats = 20;
+
+  if (argc > 1)
+  {
+    istringstream(argv[1]) >> size;
+  }
+
+  if (argc > 2)
+  {
+    istringstream(argv[2]) >> repeats;
+  }
+
+  string xml = createModel(size);
+  long baseline = getPeakRSS();
+
+#ifdef __BORLANDC__
+  unsigned long start, stop;
+#else
+  unsigned long long start, stop;
+#endif
+
+  start = getCurrentMillis();
+  SBMLDocument* document = readSBMLFromString(xml.c_str());
+  stop  = getCurrentMillis();
+  unsigned long long parse = stop - start;
+  long peak = getPeakRSS();
+
+  if (document->getNumErrors(LIBSBML_SEV_ERROR) > 0)
+  {
+    document->printErrors(cerr);
+    delete document;
+    return 1;
+  }
+
+  Model* model = document->getModel();
+  unsigned long nodes = 0;
+
+  start = getCurrentMillis();
+  for (unsigned int r = 0; r < repeats; ++r)
+  {
+    for (unsigned int n = 0; n < model->getNumReactions(); ++n)
+    {
+      nodes += countNodes(model->getReaction(n)->getKineticLaw()->getMath());
+    }
+  }
+  stop = getCurrentMillis();
+  double traversal = (stop - start) * 1.0e6 / (nodes > 0 ? nodes : 1);
+
+  start = getCurrentMillis();
+  delete document;
+  stop  = getCurrentMillis();
+
+  cout << endl;
+  cout << "  reactions             " << size << endl;
+  cout << "  math nodes            " << nodes / (repeats > 0 ? repeats : 1) << endl;
+  cout << "  parse (ms)            " << parse << endl;
+  cout << "  peak RSS growth (KB)  " << peak - baseline << endl;
+  cout << "  traversal (ns/node)   " << traversal << endl;
+  cout << "  delete (ms)           " << stop - start << endl;
+  cout << endl;
+
+  return 0;
+}
+
+END_C_DECLS
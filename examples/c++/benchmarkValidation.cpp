@@ -0,0 +1,253 @@
+/**
+ * @file    benchmarkValidation.cpp
+ * @brief   Times SBMLDocument::checkConsistency() with several threads
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This sample program is distributed under a different license than the rest
+ * of libSBML.  This program uses the open-source MIT license, as follows:
+ *
+ * Copyright (c) 2013-2018 by the California Institute of Technology
+ * (California, USA), the European Bioinformatics Institute (EMBL-EBI, UK)
+ * and the University of Heidelberg (Germany), with support from the National
+ * Institutes of Health (USA) under grant R01GM070923.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Neither the name of the California Institute of Technology (Caltech), nor
+ * of the European Bioinformatics Institute (EMBL-EBI), nor of the University
+ * of Heidelberg, nor the names of any contributors, may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * ------------------------------------------------------------------------ -->
+ */
+
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sbml/SBMLTypes.h>
+#include "util.h"
+
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+BEGIN_C_DECLS
+
+const string usage = "Usage: benchmarkValidation [numThreads [filename ...]]\n"
+                     " without files, synthetic models of increasing size"
+                     " are used";
+
+/*
+ * Creates a model with the given number of species and reactions, with
+ * mass action kinetics, units and a few rules, similar in structure to
+ * the larger curated models.
+ */
+static SBMLDocument*
+createModel (unsigned int size)
+{
+  SBMLDocument* document = new SBMLDocument(3, 1);
+  Model* model = document->createModel();
+  model->setSubstanceUnits("mole");
+  model->setTimeUnits("second");
+  model->setVolumeUnits("litre");
+  model->setExtentUnits("mole");
+
+  UnitDefinition* ud = model->createUnitDefinition();
+  ud->setId("per_second");
+  Unit* u = ud->createUnit();
+  u->initDefaults();
+  u->setKind(UNIT_KIND_SECOND);
+  u->setExponent(-1);
+
+  Compartment* c = model->createCompartment();
+  c->setId("cell");
+  c->setSize(1);
+  c->setSpatialDimensions(3.0);
+  c->setUnits("litre");
+  c->setConstant(true);
+
+  for (unsigned int n = 0; n < size; ++n)
+  {
+    ostringstream sid, kid, rid;
+    sid << "S" << n;
+    kid << "k" << n;
+    rid << "R" << n;
+
+    Species* s = model->createSpecies();
+    s->setId(sid.str());
+    s->setCompartment("cell");
+    s->setInitialAmount(1);
+    s->setSubstanceUnits("mole");
+    s->setHasOnlySubstanceUnits(true);
+    s->setBoundaryCondition(false);
+    s->setConstant(false);
+
+    Parameter* p = model->createParameter();
+    p->setId(kid.str());
+    p->setValue(0.1);
+    p->setUnits("per_second");
+    p->setConstant(true);
+
+    Reaction* r = model->createReaction();
+    r->setId(rid.str());
+    r->setReversible(false);
+    r->setFast(false);
+
+    SpeciesReference* sr = r->createReactant();
+    sr->setSpecies(sid.str());
+    sr->setStoichiometry(1);
+    sr->setConstant(true);
+
+    ostringstream product;
+    product << "S" << (n + 1) % size;
+    sr = r->createProduct();
+    sr->setSpecies(product.str());
+    sr->setStoichiometry(1);
+    sr->setConstant(true);
+
+    ASTNode* math = SBML_parseL3Formula((kid.str() + " * " + sid.str()).c_str());
+    r->createKineticLaw()->setMath(math);
+    delete math;
+  }
+
+  for (unsigned int n = 0; n < size / 10; ++n)
+  {
+    ostringstream id, formula;
+    id << "total" << n;
+    formula << "S" << n << " + S" << (n + 1) % size;
+
+    Parameter* p = model->createParameter();
+    p->setId(id.str());
+    p->setUnits("mole");
+    p->setConstant(false);
+
+    AssignmentRule* rule = model->createAssignmentRule();
+    rule->setVariable(id.str());
+    ASTNode* math = SBML_parseL3Formula(formula.str().c_str());
+    rule->setMath(math);
+    delete math;
+  }
+
+  return document;
+}
+
+
+/*
+ * Validates a copy of the document with the given number of threads.
+ *
+ * @return the time taken in milliseconds.
+ */
+static unsigned long long
+validate (const SBMLDocument* document, unsigned int numThreads,
+          unsigned int& numErrors)
+{
+  SBMLDocument* copy = document->clone();
+  copy->setNumValidationThreads(numThreads);
+
+  unsigned long long start = getCurrentMillis();
+  numErrors = copy->checkConsistency();
+  unsigned long long stop = getCurrentMillis();
+
+  delete copy;
+  return stop - start;
+}
+
+
+static bool
+benchmark (const string& name, const SBMLDocument* document,
+           unsigned int numThreads)
+{
+  unsigned int sequentialErrors, parallelErrors;
+  unsigned long long sequential = validate(document, 1, sequentialErrors);
+  unsigned long long parallel = validate(document, numThreads, parallelErrors);
+
+  cout << "  " << name << "\t" << sequential << "\t\t" << parallel
+       << "\t\t" << sequentialErrors << endl;
+
+  if (sequentialErrors != parallelErrors)
+  {
+    cerr << "different number of errors: " << sequentialErrors << " and "
+         << parallelErrors << endl;
+    return false;
+  }
+  return true;
+}
+
+
+int
+main (int argc, char* argv[])
+{
+  unsigned int numThreads = 4;
+  unsigned int sizes[] = { 500, 2000, 8000 };
+  bool ok = true;
+
+  if (argc > 1)
+  {
+    istringstream(argv[1]) >> numThreads;
+    if (numThreads == 0)
+    {
+      cerr << usage << endl;
+      return 2;
+    }
+  }
+
+  cout << endl;
+  cout << "  model\t\t1 thread (ms)\t" << numThreads << " threads (ms)\terrors"
+       << endl;
+
+  if (argc > 2)
+  {
+    for (int i = 2; i < argc; ++i)
+    {
+      SBMLDocument* document = readSBML(argv[i]);
+      if (document->getNumErrors(LIBSBML_SEV_ERROR) > 0
+        || document->getNumErrors(LIBSBML_SEV_FATAL) > 0)
+      {
+        cerr << argv[i] << " could not be read" << endl;
+        ok = false;
+      }
+      else
+      {
+        ok = benchmark(argv[i], document, numThreads) && ok;
+      }
+      delete document;
+    }
+  }
+  else
+  {
+    for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+      ostringstream name;
+      name << sizes[i] << " reactions";
+
+      SBMLDocument* document = createModel(sizes[i]);
+      ok = benchmark(name.str(), document, numThreads) && ok;
+      delete document;
+    }
+  }
+
+  cout << endl;
+  return ok ? 0 : 1;
+}
+
+END_C_DECLS
@@ -488,6 +488,7 @@ Compartment::setId (const std::string& sid)
   }
   else
   {
+    updateParentIdIndex(sid);
     mId = sid;
     return LIBSBML_OPERATION_SUCCESS;
   }
@@ -511,6 +512,7 @@ Compartment::setName (const std::string& name)
     }
     else
     {
+      updateParentIdIndex(name);
       mId = name;
       return LIBSBML_OPERATION_SUCCESS;
     }
@@ -721,6 +723,7 @@ Compartment::unsetName ()
 {
   if (getLevel() == 1) 
   {
+    updateParentIdIndex("");
     mId.erase();
   }
   else 
@@ -2018,13 +2021,7 @@ ListOfCompartments::get (const std::string& sid)
 const Compartment*
 ListOfCompartments::get (const std::string& sid) const
 {
-  vector<SBase*>::const_iterator result;
-
-  {
-    result = find_if( mItems.begin(), mItems.end(), IdEq<Compartment>(sid) );
-    return (result == mItems.end()) ? NULL : 
-                                      static_cast <Compartment*> (*result);
-  }
+  return static_cast <const Compartment*> (getItemBySId(sid));
 }
 
 
@@ -2040,18 +2037,7 @@ ListOfCompartments::remove (unsigned int n)
 Compartment*
 ListOfCompartments::remove (const std::string& sid)
 {
-  SBase* item = NULL;
-  vector<SBase*>::iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEq<Compartment>(sid) );
-
-  if (result != mItems.end())
-  {
-    item = *result;
-    mItems.erase(result);
-  }
-
-  return static_cast <Compartment*> (item);
+  return static_cast <Compartment*> (removeItemBySId(sid));
 }
 
 
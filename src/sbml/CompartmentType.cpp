@@ -187,6 +187,7 @@ CompartmentType::setId (const std::string& sid)
   }
   else
   {
+    updateParentIdIndex(sid);
     mId = sid;
     return LIBSBML_OPERATION_SUCCESS;
   }
@@ -210,6 +211,7 @@ CompartmentType::setName (const std::string& name)
     }
     else
     {
+      updateParentIdIndex(name);
       mId = name;
       return LIBSBML_OPERATION_SUCCESS;
     }
@@ -230,6 +232,7 @@ CompartmentType::unsetName ()
 {
   if (getLevel() == 1) 
   {
+    updateParentIdIndex("");
     mId.erase();
   }
   else 
@@ -755,19 +758,6 @@ ListOfCompartmentTypes::get(unsigned int n) const
 }
 
 
-/**
- * Used by ListOf::get() to lookup an SBase based by its id.
- */
-struct IdEqCT : public unary_function<SBase*, bool>
-{
-  const string& mId;
-
-  IdEqCT (const string& id) : mId(id) { }
-  bool operator() (SBase* sb) 
-       { return static_cast <CompartmentType *> (sb)->getId() == mId; }
-};
-
-
 /* return item by id */
 CompartmentType*
 ListOfCompartmentTypes::get (const std::string& sid)
@@ -781,11 +771,7 @@ ListOfCompartmentTypes::get (const std::string& sid)
 const CompartmentType*
 ListOfCompartmentTypes::get (const std::string& sid) const
 {
-  vector<SBase*>::const_iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqCT(sid) );
-  return (result == mItems.end()) ? NULL : 
-                    static_cast <CompartmentType*> (*result);  
+  return static_cast <const CompartmentType*> (getItemBySId(sid));
 }
 
 
@@ -801,18 +787,7 @@ ListOfCompartmentTypes::remove (unsigned int n)
 CompartmentType*
 ListOfCompartmentTypes::remove (const std::string& sid)
 {
-  SBase* item = NULL;
-  vector<SBase*>::iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqCT(sid) );
-
-  if (result != mItems.end())
-  {
-    item = *result;
-    mItems.erase(result);
-  }
-
-  return static_cast <CompartmentType*> (item);
+  return static_cast <CompartmentType*> (removeItemBySId(sid));
 }
 
 
@@ -0,0 +1,1149 @@
+/**
+ * @file    CompiledMath.cpp
+ * @brief   Math compiled once for repeated numerical evaluation
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sbml/CompiledMath.h>
+#include <sbml/Model.h>
+#include <sbml/math/ASTNode.h>
+#include <sbml/util/util.h>
+
+#include <limits>
+#include <math.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+#ifdef __cplusplus
+
+/** @cond doxygenLibsbmlInternal */
+
+/*
+ * The instructions operate on a stack of values.  Operands are pushed
+ * by the first three; PIECEWISE replaces its 'arg' operands by one value,
+ * the binary operations replace two and the unary ones replace one.
+ */
+enum CompiledMathOp
+{
+    OP_CONSTANT
+  , OP_VARIABLE
+  , OP_TREE
+  , OP_PIECEWISE
+
+  , OP_ADD
+  , OP_SUBTRACT
+  , OP_MULTIPLY
+  , OP_DIVIDE
+  , OP_POWER
+  , OP_ROOT
+  , OP_AND
+  , OP_OR
+  , OP_XOR
+  , OP_EQ
+  , OP_GEQ
+  , OP_GT
+  , OP_LEQ
+  , OP_LT
+  , OP_NEQ
+
+  , OP_NEGATE
+  , OP_NOT
+  , OP_ABS
+  , OP_ARCCOS
+  , OP_ARCCOSH
+  , OP_ARCCOT
+  , OP_ARCCOTH
+  , OP_ARCCSC
+  , OP_ARCCSCH
+  , OP_ARCSEC
+  , OP_ARCSECH
+  , OP_ARCSIN
+  , OP_ARCSINH
+  , OP_ARCTAN
+  , OP_ARCTANH
+  , OP_CEILING
+  , OP_COS
+  , OP_COSH
+  , OP_COT
+  , OP_COTH
+  , OP_CSC
+  , OP_CSCH
+  , OP_EXP
+  , OP_FACTORIAL
+  , OP_FLOOR
+  , OP_LN
+  , OP_LOG10
+  , OP_SEC
+  , OP_SECH
+  , OP_SIN
+  , OP_SINH
+  , OP_TAN
+  , OP_TANH
+};
+
+static const int OP_FIRST_UNARY = OP_NEGATE;
+
+/* guards against function definitions that call themselves */
+static const unsigned int MAX_EXPANSION_DEPTH = 64;
+
+/* number of sets of values evaluated together by the batch evaluation */
+static const unsigned int BLOCK_SIZE = 64;
+
+/* stack kept on the (C) stack when evaluating a single set of values */
+static const unsigned int LOCAL_STACK_SIZE = 32;
+
+
+static double
+getNaN()
+{
+  return numeric_limits<double>::quiet_NaN();
+}
+
+
+/*
+ * The operations compute exactly what SBMLTransforms::evaluateASTNode()
+ * computes for the corresponding math.
+ */
+static double
+applyUnary(int op, double x)
+{
+  double result = 0;
+  int i;
+
+  switch (op)
+  {
+  case OP_NEGATE:     return -x;
+  case OP_NOT:        return (double)(!x);
+  case OP_ABS:        return fabs(x);
+  case OP_ARCCOS:     return acos(x);
+  case OP_ARCCOSH:    return log(x + pow(x - 1, 0.5) * pow(x + 1, 0.5));
+  case OP_ARCCOT:     return atan(1.0 / x);
+  case OP_ARCCOTH:    return (1.0 / 2.0) * log((x + 1.0) / (x - 1.0));
+  case OP_ARCCSC:     return asin(1.0 / x);
+  case OP_ARCCSCH:    return log((1.0 + pow(1.0 + pow(x, 2), 0.5)) / x);
+  case OP_ARCSEC:     return acos(1.0 / x);
+  case OP_ARCSECH:    return log((1.0 + pow((1.0 - pow(x, 2)), 0.5)) / x);
+  case OP_ARCSIN:     return asin(x);
+  case OP_ARCSINH:    return log(x + pow((1.0 + pow(x, 2)), 0.5));
+  case OP_ARCTAN:     return atan(x);
+  case OP_ARCTANH:    return 0.5 * log((1.0 + x) / (1.0 - x));
+  case OP_CEILING:    return ceil(x);
+  case OP_COS:        return cos(x);
+  case OP_COSH:       return cosh(x);
+  case OP_COT:        return 1.0 / tan(x);
+  case OP_COTH:       return cosh(x) / sinh(x);
+  case OP_CSC:        return 1.0 / sin(x);
+  case OP_CSCH:       return 1.0 / sinh(x);
+  case OP_EXP:        return exp(x);
+  case OP_FLOOR:      return floor(x);
+  case OP_LN:         return log(x);
+  case OP_LOG10:      return log10(x);
+  case OP_SEC:        return 1.0 / cos(x);
+  case OP_SECH:       return 1.0 / cosh(x);
+  case OP_SIN:        return sin(x);
+  case OP_SINH:       return sinh(x);
+  case OP_TAN:        return tan(x);
+  case OP_TANH:       return tanh(x);
+
+  case OP_FACTORIAL:
+    i = (int)(floor(x));
+    for (result = 1; i > 1; --i)
+    {
+      result *= i;
+    }
+    return result;
+
+  default:
+    return getNaN();
+  }
+}
+
+
+static double
+applyBinary(int op, double a, double b)
+{
+  switch (op)
+  {
+  case OP_ADD:        return a + b;
+  case OP_SUBTRACT:   return a - b;
+  case OP_MULTIPLY:   return a * b;
+  case OP_DIVIDE:     return a / b;
+  case OP_POWER:      return pow(a, b);
+  case OP_ROOT:       return pow(b, 1.0 / a);
+  case OP_AND:        return (double)(a && b);
+  case OP_OR:         return (double)(a || b);
+  case OP_XOR:        return (double)((!a && b) || (a && !b));
+  case OP_EQ:         return (double)(a == b);
+  case OP_GEQ:        return (double)(a >= b);
+  case OP_GT:         return (double)(a > b);
+  case OP_LEQ:        return (double)(a <= b);
+  case OP_LT:         return (double)(a < b);
+  case OP_NEQ:        return (double)(a != b);
+  default:            return getNaN();
+  }
+}
+
+
+/*
+ * args holds the values of the children of the piecewise: value,
+ * condition, value, condition, ... and possibly the otherwise value.
+ */
+static double
+applyPiecewise(const double * args, unsigned int numArgs)
+{
+  double result = 0;
+  bool assigned = false;
+  unsigned int numPieces = numArgs / 2;
+
+  for (unsigned int j = 0; j < 2 * numPieces; j += 2)
+  {
+    if (args[j + 1] == 1.0)
+    {
+      // we might have two true piece statements
+      // if the values are the same - fine
+      // if not then the result is undefined
+      if (assigned)
+      {
+        if (args[j] != result)
+        {
+          result = getNaN();
+        }
+      }
+      else
+      {
+        result = args[j];
+        assigned = true;
+      }
+    }
+  }
+
+  if (!assigned)
+  {
+    result = (numArgs % 2 == 0) ? getNaN() : args[numArgs - 1];
+  }
+
+  return result;
+}
+
+
+static int
+getOperation(ASTNodeType_t type)
+{
+  switch (type)
+  {
+  case AST_DIVIDE:              return OP_DIVIDE;
+  case AST_POWER:
+  case AST_FUNCTION_POWER:      return OP_POWER;
+  case AST_FUNCTION_ROOT:       return OP_ROOT;
+  case AST_LOGICAL_AND:         return OP_AND;
+  case AST_LOGICAL_OR:          return OP_OR;
+  case AST_LOGICAL_XOR:         return OP_XOR;
+  case AST_RELATIONAL_EQ:       return OP_EQ;
+  case AST_RELATIONAL_GEQ:      return OP_GEQ;
+  case AST_RELATIONAL_GT:       return OP_GT;
+  case AST_RELATIONAL_LEQ:      return OP_LEQ;
+  case AST_RELATIONAL_LT:       return OP_LT;
+  case AST_RELATIONAL_NEQ:      return OP_NEQ;
+  case AST_LOGICAL_NOT:         return OP_NOT;
+  case AST_FUNCTION_ABS:        return OP_ABS;
+  case AST_FUNCTION_ARCCOS:     return OP_ARCCOS;
+  case AST_FUNCTION_ARCCOSH:    return OP_ARCCOSH;
+  case AST_FUNCTION_ARCCOT:     return OP_ARCCOT;
+  case AST_FUNCTION_ARCCOTH:    return OP_ARCCOTH;
+  case AST_FUNCTION_ARCCSC:     return OP_ARCCSC;
+  case AST_FUNCTION_ARCCSCH:    return OP_ARCCSCH;
+  case AST_FUNCTION_ARCSEC:     return OP_ARCSEC;
+  case AST_FUNCTION_ARCSECH:    return OP_ARCSECH;
+  case AST_FUNCTION_ARCSIN:     return OP_ARCSIN;
+  case AST_FUNCTION_ARCSINH:    return OP_ARCSINH;
+  case AST_FUNCTION_ARCTAN:     return OP_ARCTAN;
+  case AST_FUNCTION_ARCTANH:    return OP_ARCTANH;
+  case AST_FUNCTION_CEILING:    return OP_CEILING;
+  case AST_FUNCTION_COS:        return OP_COS;
+  case AST_FUNCTION_COSH:       return OP_COSH;
+  case AST_FUNCTION_COT:        return OP_COT;
+  case AST_FUNCTION_COTH:       return OP_COTH;
+  case AST_FUNCTION_CSC:        return OP_CSC;
+  case AST_FUNCTION_CSCH:       return OP_CSCH;
+  case AST_FUNCTION_EXP:        return OP_EXP;
+  case AST_FUNCTION_FACTORIAL:  return OP_FACTORIAL;
+  case AST_FUNCTION_FLOOR:      return OP_FLOOR;
+  case AST_FUNCTION_LN:         return OP_LN;
+  case AST_FUNCTION_LOG:        return OP_LOG10;
+  case AST_FUNCTION_SEC:        return OP_SEC;
+  case AST_FUNCTION_SECH:       return OP_SECH;
+  case AST_FUNCTION_SIN:        return OP_SIN;
+  case AST_FUNCTION_SINH:       return OP_SINH;
+  case AST_FUNCTION_TAN:        return OP_TAN;
+  case AST_FUNCTION_TANH:       return OP_TANH;
+  default:                      return -1;
+  }
+}
+
+
+/*
+ * Components whose value is set but not known (NaN) take their value
+ * from a rule, an initial assignment or a kinetic law, in that order.
+ */
+static bool
+getDefiningMath(const EvaluationContext& context, const std::string& id,
+                const ASTNode*& math)
+{
+  const Model * m = context.getModel();
+  const SBMLTransforms::IdValueMap& values = context.getValues();
+  SBMLTransforms::IdValueMap::const_iterator it = values.find(id);
+
+  if (m == NULL || it == values.end()
+    || !util_isNaN(it->second.first) || !it->second.second)
+  {
+    return false;
+  }
+
+  const Rule *r = m->getRule(id);
+  const InitialAssignment *ia = m->getInitialAssignment(id);
+  const Reaction *rn = m->getReaction(id);
+  if (r != NULL)
+  {
+    math = r->getMath();
+  }
+  else if (ia != NULL)
+  {
+    math = ia->getMath();
+  }
+  else if (rn != NULL && rn->isSetKineticLaw())
+  {
+    math = rn->getKineticLaw()->getMath();
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+
+CompiledMath::CompiledMath(const ASTNode * node,
+                           const EvaluationContext& context,
+                           const std::vector<std::string>& variables) :
+    mVariables (variables)
+  , mCode ()
+  , mConstants ()
+  , mDepth (0)
+  , mMaxDepth (0)
+  , mTrees ()
+  , mValues ()
+  , mModel (NULL)
+  , mFunctionDefinitions (NULL)
+{
+  compile(node, context);
+}
+
+
+CompiledMath::CompiledMath(const ASTNode * node, const Model * m,
+                           const std::vector<std::string>& variables) :
+    mVariables (variables)
+  , mCode ()
+  , mConstants ()
+  , mDepth (0)
+  , mMaxDepth (0)
+  , mTrees ()
+  , mValues ()
+  , mModel (NULL)
+  , mFunctionDefinitions (NULL)
+{
+  EvaluationContext context(m);
+  compile(node, context);
+}
+
+
+CompiledMath::CompiledMath(const CompiledMath& orig) :
+    mVariables (orig.mVariables)
+  , mCode (orig.mCode)
+  , mConstants (orig.mConstants)
+  , mDepth (orig.mDepth)
+  , mMaxDepth (orig.mMaxDepth)
+  , mTrees ()
+  , mValues (orig.mValues)
+  , mModel (orig.mModel)
+  , mFunctionDefinitions (orig.mFunctionDefinitions)
+{
+  copyTrees(orig);
+}
+
+
+CompiledMath&
+CompiledMath::operator=(const CompiledMath& rhs)
+{
+  if (&rhs != this)
+  {
+    mVariables = rhs.mVariables;
+    mCode = rhs.mCode;
+    mConstants = rhs.mConstants;
+    mDepth = rhs.mDepth;
+    mMaxDepth = rhs.mMaxDepth;
+    mValues = rhs.mValues;
+    mModel = rhs.mModel;
+    mFunctionDefinitions = rhs.mFunctionDefinitions;
+    deleteTrees();
+    copyTrees(rhs);
+  }
+  return *this;
+}
+
+
+CompiledMath::~CompiledMath()
+{
+  deleteTrees();
+}
+
+
+unsigned int
+CompiledMath::getNumVariables() const
+{
+  return (unsigned int)mVariables.size();
+}
+
+
+const std::string&
+CompiledMath::getVariable(unsigned int n) const
+{
+  static const std::string empty;
+  return (n < mVariables.size()) ? mVariables[n] : empty;
+}
+
+
+int
+CompiledMath::getVariableIndex(const std::string& name) const
+{
+  for (unsigned int n = 0; n < mVariables.size(); ++n)
+  {
+    if (mVariables[n] == name)
+    {
+      return (int)n;
+    }
+  }
+  return -1;
+}
+
+
+unsigned int
+CompiledMath::getNumInstructions() const
+{
+  return (unsigned int)mCode.size();
+}
+
+
+bool
+CompiledMath::usesTreeEvaluation() const
+{
+  return !mTrees.empty();
+}
+
+
+double
+CompiledMath::evaluate(const double * values) const
+{
+  if (values == NULL && !mVariables.empty())
+  {
+    return getNaN();
+  }
+
+  if (mMaxDepth <= LOCAL_STACK_SIZE)
+  {
+    double stack[LOCAL_STACK_SIZE];
+    return run(0, mCode.size(), values, stack);
+  }
+
+  std::vector<double> stack(mMaxDepth);
+  return run(0, mCode.size(), values, &stack[0]);
+}
+
+
+void
+CompiledMath::evaluate(const double * values, unsigned int numSets,
+                       double * results) const
+{
+  if (numSets == 0 || results == NULL)
+  {
+    return;
+  }
+
+  if (values == NULL && !mVariables.empty())
+  {
+    for (unsigned int i = 0; i < numSets; ++i)
+    {
+      results[i] = getNaN();
+    }
+    return;
+  }
+
+  std::vector<double> stack(mMaxDepth * BLOCK_SIZE);
+  for (unsigned int offset = 0; offset < numSets; offset += BLOCK_SIZE)
+  {
+    unsigned int width = numSets - offset;
+    if (width > BLOCK_SIZE)
+    {
+      width = BLOCK_SIZE;
+    }
+    runBlock(values, numSets, offset, width, &stack[0], results);
+  }
+}
+
+
+void
+CompiledMath::compile(const ASTNode * node, const EvaluationContext& context)
+{
+  std::set<std::string> expanding;
+  compileNode(node, context, expanding, 0);
+}
+
+
+void
+CompiledMath::compileNode(const ASTNode * node,
+                          const EvaluationContext& context,
+                          std::set<std::string>& expanding,
+                          unsigned int depth)
+{
+  if (node == NULL)
+  {
+    emitConstant(getNaN());
+    return;
+  }
+
+  size_t start = mCode.size();
+  unsigned int numChildren = node->getNumChildren();
+  ASTNodeType_t type = node->getType();
+
+  switch (type)
+  {
+  case AST_INTEGER:
+    emitConstant((double)(node->getInteger()));
+    break;
+
+  case AST_REAL:
+  case AST_REAL_E:
+  case AST_RATIONAL:
+  case AST_NAME_AVOGADRO:
+    emitConstant(node->getReal());
+    break;
+
+  case AST_NAME:
+    if (!compileName(node, context, expanding, depth))
+    {
+      emitConstant(getNaN());
+    }
+    break;
+
+  case AST_NAME_TIME:
+  case AST_CONSTANT_FALSE:
+    emitConstant(0.0);
+    break;
+
+  case AST_CONSTANT_E:
+    /* exp(1) is used to adjust exponentiale to machine precision */
+    emitConstant(exp(1.0));
+    break;
+
+  case AST_CONSTANT_PI:
+    /* pi = 4 * atan 1  is used to adjust Pi to machine precision */
+    emitConstant(4.0*atan(1.0));
+    break;
+
+  case AST_CONSTANT_TRUE:
+    emitConstant(1.0);
+    break;
+
+  case AST_LAMBDA:
+  case AST_FUNCTION_DELAY:
+    emitConstant(getNaN());
+    break;
+
+  case AST_FUNCTION:
+    {
+      const ListOfFunctionDefinitions *lfd =
+                                   context.getListOfFunctionDefinitions();
+      if (lfd != NULL && node->getName() != NULL
+        && lfd->get(node->getName()) != NULL
+        && depth < MAX_EXPANSION_DEPTH)
+      {
+        ASTNode *tempNode = node->deepCopy();
+        SBMLTransforms::replaceFD(tempNode, lfd);
+        compileNode(tempNode, context, expanding, depth + 1);
+        delete tempNode;
+      }
+      else
+      {
+        emitConstant(getNaN());
+      }
+    }
+    break;
+
+  case AST_PLUS:
+  case AST_TIMES:
+    if (numChildren == 0)
+    {
+      emitConstant(type == AST_PLUS ? 0.0 : 1.0);
+    }
+    else
+    {
+      compileChild(node, 0, context, expanding, depth);
+      for (unsigned int j = 1; j < numChildren; ++j)
+      {
+        compileChild(node, j, context, expanding, depth);
+        emit(type == AST_PLUS ? OP_ADD : OP_MULTIPLY);
+      }
+    }
+    break;
+
+  case AST_MINUS:
+    compileChild(node, 0, context, expanding, depth);
+    if (numChildren == 1)
+    {
+      emit(OP_NEGATE);
+    }
+    else
+    {
+      compileChild(node, 1, context, expanding, depth);
+      emit(OP_SUBTRACT);
+    }
+    break;
+
+  case AST_DIVIDE:
+  case AST_POWER:
+  case AST_FUNCTION_POWER:
+  case AST_FUNCTION_ROOT:
+    compileChild(node, 0, context, expanding, depth);
+    compileChild(node, 1, context, expanding, depth);
+    emit(getOperation(type));
+    break;
+
+  case AST_FUNCTION_LOG:
+    /* the base is not taken into account */
+    compileChild(node, 1, context, expanding, depth);
+    emit(OP_LOG10);
+    break;
+
+  case AST_FUNCTION_PIECEWISE:
+    if (numChildren == 0)
+    {
+      emitConstant(getNaN());
+    }
+    else
+    {
+      for (unsigned int j = 0; j < numChildren; ++j)
+      {
+        compileChild(node, j, context, expanding, depth);
+      }
+      emit(OP_PIECEWISE, numChildren);
+    }
+    break;
+
+  case AST_LOGICAL_AND:
+  case AST_LOGICAL_OR:
+  case AST_LOGICAL_XOR:
+    if (numChildren == 0)
+    {
+      emitConstant(type == AST_LOGICAL_AND ? 1.0 : 0.0);
+    }
+    else if (numChildren == 1)
+    {
+      compileChild(node, 0, context, expanding, depth);
+    }
+    else
+    {
+      /* only the first two children are taken into account */
+      compileChild(node, 0, context, expanding, depth);
+      compileChild(node, 1, context, expanding, depth);
+      emit(getOperation(type));
+    }
+    break;
+
+  case AST_RELATIONAL_EQ:
+  case AST_RELATIONAL_GEQ:
+  case AST_RELATIONAL_GT:
+  case AST_RELATIONAL_LEQ:
+  case AST_RELATIONAL_LT:
+  case AST_RELATIONAL_NEQ:
+    if (numChildren < 2)
+    {
+      emitConstant(0.0);
+    }
+    else
+    {
+      emitConstant(1.0);
+      for (unsigned int j = 1; j < numChildren; ++j)
+      {
+        compileChild(node, j - 1, context, expanding, depth);
+        compileChild(node, j, context, expanding, depth);
+        emit(getOperation(type));
+        emit(OP_MULTIPLY);
+      }
+    }
+    break;
+
+  default:
+    if (getOperation(type) >= OP_FIRST_UNARY)
+    {
+      compileChild(node, 0, context, expanding, depth);
+      emit(getOperation(type));
+    }
+    else
+    {
+      compileTree(node, context, expanding);
+    }
+    break;
+  }
+
+  fold(start);
+}
+
+
+void
+CompiledMath::compileChild(const ASTNode * node, unsigned int n,
+                           const EvaluationContext& context,
+                           std::set<std::string>& expanding,
+                           unsigned int depth)
+{
+  compileNode(node->getChild(n), context, expanding, depth);
+}
+
+
+bool
+CompiledMath::compileName(const ASTNode * node,
+                          const EvaluationContext& context,
+                          std::set<std::string>& expanding,
+                          unsigned int depth)
+{
+  if (node->getName() == NULL)
+  {
+    return false;
+  }
+
+  const std::string name = node->getName();
+  int index = getVariableIndex(name);
+  if (index >= 0)
+  {
+    emit(OP_VARIABLE, (unsigned int)index);
+    return true;
+  }
+
+  const SBMLTransforms::IdValueMap& values = context.getValues();
+  SBMLTransforms::IdValueMap::const_iterator it = values.find(name);
+  if (it == values.end())
+  {
+    return false;
+  }
+
+  const ASTNode * math = NULL;
+  if (getDefiningMath(context, name, math))
+  {
+    if (expanding.find(name) != expanding.end())
+    {
+      return false;
+    }
+
+    expanding.insert(name);
+    compileNode(math, context, expanding, depth);
+    expanding.erase(name);
+    return true;
+  }
+
+  emitConstant(it->second.first);
+  return true;
+}
+
+
+/*
+ * Math this class does not know about (i.e., from packages) is left to
+ * SBMLTransforms::evaluateASTNode().  The components it refers to are
+ * replaced by their defining math first, so that the variables occurring
+ * in that math can be given their values.
+ */
+void
+CompiledMath::compileTree(const ASTNode * node,
+                          const EvaluationContext& context,
+                          std::set<std::string>& expanding)
+{
+  ASTNode * tree = node->deepCopy();
+  substituteDefinitions(tree, context, expanding);
+
+  if (!containsVariable(tree))
+  {
+    EvaluationContext treeContext(context.getValues(), context.getModel());
+    treeContext.setListOfFunctionDefinitions(
+                                   context.getListOfFunctionDefinitions());
+    emitConstant(treeContext.evaluate(tree));
+    delete tree;
+    return;
+  }
+
+  if (mTrees.empty())
+  {
+    mValues = context.getValues();
+    mModel = context.getModel();
+    mFunctionDefinitions = context.getListOfFunctionDefinitions();
+  }
+  mTrees.push_back(tree);
+  emit(OP_TREE, (unsigned int)(mTrees.size() - 1));
+}
+
+
+void
+CompiledMath::substituteDefinitions(ASTNode * node,
+                                    const EvaluationContext& context,
+                                    std::set<std::string>& expanding) const
+{
+  if (node == NULL)
+  {
+    return;
+  }
+
+  if (node->getType() == AST_NAME && node->getName() != NULL)
+  {
+    const std::string name = node->getName();
+    const ASTNode * math = NULL;
+    if (getVariableIndex(name) < 0
+      && getDefiningMath(context, name, math) && math != NULL
+      && expanding.find(name) == expanding.end())
+    {
+      (*node) = *math;
+      expanding.insert(name);
+      substituteDefinitions(node, context, expanding);
+      expanding.erase(name);
+      return;
+    }
+  }
+
+  for (unsigned int i = 0; i < node->getNumChildren(); ++i)
+  {
+    substituteDefinitions(node->getChild(i), context, expanding);
+  }
+}
+
+
+bool
+CompiledMath::containsVariable(const ASTNode * node) const
+{
+  if (node == NULL)
+  {
+    return false;
+  }
+
+  if (node->getType() == AST_NAME && node->getName() != NULL
+    && getVariableIndex(node->getName()) >= 0)
+  {
+    return true;
+  }
+
+  for (unsigned int i = 0; i < node->getNumChildren(); ++i)
+  {
+    if (containsVariable(node->getChild(i)))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+void
+CompiledMath::emit(int op, unsigned int arg)
+{
+  Instruction instruction;
+  instruction.op = op;
+  instruction.arg = arg;
+  mCode.push_back(instruction);
+
+  if (op == OP_CONSTANT || op == OP_VARIABLE || op == OP_TREE)
+  {
+    ++mDepth;
+  }
+  else if (op == OP_PIECEWISE)
+  {
+    mDepth -= arg - 1;
+  }
+  else if (op < OP_FIRST_UNARY)
+  {
+    --mDepth;
+  }
+
+  if (mDepth > mMaxDepth)
+  {
+    mMaxDepth = mDepth;
+  }
+}
+
+
+void
+CompiledMath::emitConstant(double value)
+{
+  mConstants.push_back(value);
+  emit(OP_CONSTANT, (unsigned int)(mConstants.size() - 1));
+}
+
+
+/*
+ * Replaces the instructions from start on, which compute a single value,
+ * by that value if it does not depend on a variable.
+ */
+void
+CompiledMath::fold(size_t start)
+{
+  if (mCode.size() - start <= 1)
+  {
+    return;
+  }
+
+  size_t firstConstant = mConstants.size();
+  for (size_t n = start; n < mCode.size(); ++n)
+  {
+    if (mCode[n].op == OP_VARIABLE || mCode[n].op == OP_TREE)
+    {
+      return;
+    }
+    if (mCode[n].op == OP_CONSTANT && mCode[n].arg < firstConstant)
+    {
+      firstConstant = mCode[n].arg;
+    }
+  }
+
+  std::vector<double> stack(mMaxDepth);
+  double value = run(start, mCode.size(), NULL, &stack[0]);
+
+  mCode.resize(start);
+  mConstants.resize(firstConstant);
+  --mDepth;
+  emitConstant(value);
+}
+
+
+double
+CompiledMath::run(size_t begin, size_t end, const double * values,
+                  double * stack) const
+{
+  unsigned int sp = 0;
+
+  for (size_t n = begin; n < end; ++n)
+  {
+    const Instruction& instruction = mCode[n];
+    int op = instruction.op;
+
+    if (op == OP_CONSTANT)
+    {
+      stack[sp++] = mConstants[instruction.arg];
+    }
+    else if (op == OP_VARIABLE)
+    {
+      stack[sp++] = values[instruction.arg];
+    }
+    else if (op == OP_TREE)
+    {
+      stack[sp++] = evaluateTree(instruction.arg, values, 1);
+    }
+    else if (op == OP_PIECEWISE)
+    {
+      sp -= instruction.arg;
+      stack[sp] = applyPiecewise(stack + sp, instruction.arg);
+      ++sp;
+    }
+    else if (op < OP_FIRST_UNARY)
+    {
+      --sp;
+      stack[sp - 1] = applyBinary(op, stack[sp - 1], stack[sp]);
+    }
+    else
+    {
+      stack[sp - 1] = applyUnary(op, stack[sp - 1]);
+    }
+  }
+
+  return stack[0];
+}
+
+
+/*
+ * Evaluates the sets of values offset .. offset + width - 1 together,
+ * one instruction at a time, so that the loops over the sets can be
+ * vectorized by the compiler.  Row r of the stack (BLOCK_SIZE values)
+ * holds the rth operand of all sets.
+ */
+void
+CompiledMath::runBlock(const double * values, unsigned int numSets,
+                       unsigned int offset, unsigned int width,
+                       double * stack, double * results) const
+{
+  unsigned int sp = 0;
+  std::vector<double> args;
+
+  for (size_t n = 0; n < mCode.size(); ++n)
+  {
+    const Instruction& instruction = mCode[n];
+    int op = instruction.op;
+    unsigned int i;
+
+    if (op == OP_CONSTANT)
+    {
+      double * row = stack + sp * BLOCK_SIZE;
+      const double value = mConstants[instruction.arg];
+      for (i = 0; i < width; ++i) row[i] = value;
+      ++sp;
+    }
+    else if (op == OP_VARIABLE)
+    {
+      double * row = stack + sp * BLOCK_SIZE;
+      const double * column = values + instruction.arg * numSets + offset;
+      for (i = 0; i < width; ++i) row[i] = column[i];
+      ++sp;
+    }
+    else if (op == OP_TREE)
+    {
+      double * row = stack + sp * BLOCK_SIZE;
+      for (i = 0; i < width; ++i)
+      {
+        row[i] = evaluateTree(instruction.arg, values + offset + i, numSets);
+      }
+      ++sp;
+    }
+    else if (op == OP_PIECEWISE)
+    {
+      sp -= instruction.arg;
+      double * row = stack + sp * BLOCK_SIZE;
+      args.resize(instruction.arg);
+      for (i = 0; i < width; ++i)
+      {
+        for (unsigned int k = 0; k < instruction.arg; ++k)
+        {
+          args[k] = row[k * BLOCK_SIZE + i];
+        }
+        row[i] = applyPiecewise(&args[0], instruction.arg);
+      }
+      ++sp;
+    }
+    else if (op < OP_FIRST_UNARY)
+    {
+      --sp;
+      double * a = stack + (sp - 1) * BLOCK_SIZE;
+      const double * b = stack + sp * BLOCK_SIZE;
+      switch (op)
+      {
+      case OP_ADD:
+        for (i = 0; i < width; ++i) a[i] += b[i];
+        break;
+      case OP_SUBTRACT:
+        for (i = 0; i < width; ++i) a[i] -= b[i];
+        break;
+      case OP_MULTIPLY:
+        for (i = 0; i < width; ++i) a[i] *= b[i];
+        break;
+      case OP_DIVIDE:
+        for (i = 0; i < width; ++i) a[i] /= b[i];
+        break;
+      default:
+        for (i = 0; i < width; ++i) a[i] = applyBinary(op, a[i], b[i]);
+        break;
+      }
+    }
+    else
+    {
+      double * a = stack + (sp - 1) * BLOCK_SIZE;
+      if (op == OP_NEGATE)
+      {
+        for (i = 0; i < width; ++i) a[i] = -a[i];
+      }
+      else
+      {
+        for (i = 0; i < width; ++i) a[i] = applyUnary(op, a[i]);
+      }
+    }
+  }
+
+  for (unsigned int i = 0; i < width; ++i)
+  {
+    results[offset + i] = stack[i];
+  }
+}
+
+
+/*
+ * The value of variable v is values[v * stride].
+ */
+double
+CompiledMath::evaluateTree(unsigned int n, const double * values,
+                           unsigned int stride) const
+{
+  ASTNode * tree = mTrees[n]->deepCopy();
+  assignValues(tree, values, stride);
+
+  EvaluationContext context(mValues, mModel);
+  context.setListOfFunctionDefinitions(mFunctionDefinitions);
+  double result = context.evaluate(tree);
+
+  delete tree;
+  return result;
+}
+
+
+void
+CompiledMath::assignValues(ASTNode * node, const double * values,
+                           unsigned int stride) const
+{
+  if (node->getType() == AST_NAME && node->getName() != NULL)
+  {
+    int index = getVariableIndex(node->getName());
+    if (index >= 0)
+    {
+      node->setValue(values[index * stride]);
+      return;
+    }
+  }
+
+  for (unsigned int i = 0; i < node->getNumChildren(); ++i)
+  {
+    assignValues(node->getChild(i), values, stride);
+  }
+}
+
+
+void
+CompiledMath::copyTrees(const CompiledMath& orig)
+{
+  for (size_t n = 0; n < orig.mTrees.size(); ++n)
+  {
+    mTrees.push_back(orig.mTrees[n]->deepCopy());
+  }
+}
+
+
+void
+CompiledMath::deleteTrees()
+{
+  for (size_t n = 0; n < mTrees.size(); ++n)
+  {
+    delete mTrees[n];
+  }
+  mTrees.clear();
+}
+
+/** @endcond */
+
+#endif /* __cplusplus */
+/** @cond doxygenIgnored */
+/** @endcond */
+
+LIBSBML_CPP_NAMESPACE_END
@@ -0,0 +1,212 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    CompiledMath.h
+ * @brief   Math compiled once for repeated numerical evaluation
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class CompiledMath
+ * @sbmlbrief{core} Math compiled for repeated numerical evaluation
+ *
+ */
+
+#ifndef CompiledMath_h
+#define CompiledMath_h
+
+
+#include <sbml/common/extern.h>
+#include <sbml/SBMLTransforms.h>
+
+#ifdef __cplusplus
+
+
+#include <set>
+#include <string>
+#include <vector>
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+class ASTNode;
+class Model;
+
+#ifndef SWIG
+
+/**
+ * A CompiledMath is the math of an ASTNode, translated once into a flat
+ * array of instructions so that it can be evaluated many times (e.g., in
+ * parameter scans) without walking the tree, looking up names or expanding
+ * function definitions again.
+ *
+ * The names listed as variables are given a value for every evaluation;
+ * they are numbered in the order given.  All other names are resolved
+ * when compiling, exactly as SBMLTransforms::evaluateASTNode() would
+ * resolve them with the given EvaluationContext, and the parts of the math
+ * that do not depend on any variable are reduced to their values.
+ *
+ * Math from SBML Level&nbsp;3 packages is handed to the tree evaluator
+ * where it depends on a variable; the model of the context must then
+ * outlive the CompiledMath.
+ *
+ * Evaluating does not modify the CompiledMath, so that one object may be
+ * used from several threads at once.
+ */
+class LIBSBML_EXTERN CompiledMath
+{
+public:
+
+  /**
+   * Compiles the math using the values, model and function definitions
+   * of the given context.
+   */
+  CompiledMath(const ASTNode * node, const EvaluationContext& context,
+               const std::vector<std::string>& variables =
+                                          std::vector<std::string>());
+
+
+  /**
+   * Compiles the math using the values of the components of the given
+   * model.
+   */
+  CompiledMath(const ASTNode * node, const Model * m,
+               const std::vector<std::string>& variables =
+                                          std::vector<std::string>());
+
+
+  CompiledMath(const CompiledMath& orig);
+
+
+  CompiledMath& operator=(const CompiledMath& rhs);
+
+
+  ~CompiledMath();
+
+
+  unsigned int getNumVariables() const;
+
+
+  /**
+   * @return the name of the nth variable, or an empty string.
+   */
+  const std::string& getVariable(unsigned int n) const;
+
+
+  /**
+   * @return the index of the variable with the given name, or -1.
+   */
+  int getVariableIndex(const std::string& name) const;
+
+
+  unsigned int getNumInstructions() const;
+
+
+  /**
+   * @return @c true if evaluating the math involves the tree evaluator
+   * (for math from packages that depends on a variable).
+   */
+  bool usesTreeEvaluation() const;
+
+
+  /**
+   * @return the value of the math for the given values of the variables
+   * (one per variable, in order; may be @c NULL if there are none), or
+   * NaN if it cannot be evaluated.
+   */
+  double evaluate(const double * values = NULL) const;
+
+
+  /**
+   * Evaluates the math for @p numSets sets of values of the variables at
+   * once.  The values are given per variable (struct of arrays): the value
+   * of variable @c v in set @c i is <code>values[v * numSets + i]</code>.
+   * The result for set @c i is stored in <code>results[i]</code>.
+   */
+  void evaluate(const double * values, unsigned int numSets,
+                double * results) const;
+
+
+private:
+
+  struct Instruction
+  {
+    int          op;
+    unsigned int arg;
+  };
+
+  void compile(const ASTNode * node, const EvaluationContext& context);
+
+  void compileNode(const ASTNode * node, const EvaluationContext& context,
+                   std::set<std::string>& expanding, unsigned int depth);
+
+  void compileChild(const ASTNode * node, unsigned int n,
+                    const EvaluationContext& context,
+                    std::set<std::string>& expanding, unsigned int depth);
+
+  bool compileName(const ASTNode * node, const EvaluationContext& context,
+                   std::set<std::string>& expanding, unsigned int depth);
+
+  void compileTree(const ASTNode * node, const EvaluationContext& context,
+                   std::set<std::string>& expanding);
+
+  void substituteDefinitions(ASTNode * node,
+                             const EvaluationContext& context,
+                             std::set<std::string>& expanding) const;
+
+  bool containsVariable(const ASTNode * node) const;
+
+  void emit(int op, unsigned int arg = 0);
+
+  void emitConstant(double value);
+
+  void fold(size_t start);
+
+  double run(size_t begin, size_t end, const double * values,
+             double * stack) const;
+
+  void runBlock(const double * values, unsigned int numSets,
+                unsigned int offset, unsigned int width,
+                double * stack, double * results) const;
+
+  double evaluateTree(unsigned int n, const double * values,
+                      unsigned int stride) const;
+
+  void assignValues(ASTNode * node, const double * values,
+                    unsigned int stride) const;
+
+  void copyTrees(const CompiledMath& orig);
+
+  void deleteTrees();
+
+  std::vector<std::string> mVariables;
+  std::vector<Instruction> mCode;
+  std::vector<double> mConstants;
+  unsigned int mDepth;
+  unsigned int mMaxDepth;
+
+  std::vector<ASTNode *> mTrees;
+  SBMLTransforms::IdValueMap mValues;
+  const Model * mModel;
+  const ListOfFunctionDefinitions * mFunctionDefinitions;
+};
+
+#endif
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* CompiledMath_h */
+/** @endcond */
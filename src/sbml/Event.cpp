@@ -521,6 +521,7 @@ Event::setId (const std::string& sid)
   }
   else
   {
+    updateParentIdIndex(sid);
     mId = sid;
     return LIBSBML_OPERATION_SUCCESS;
   }
@@ -544,6 +545,7 @@ Event::setName (const std::string& name)
     }
     else
     {
+      updateParentIdIndex(name);
       mId = name;
       return LIBSBML_OPERATION_SUCCESS;
     }
@@ -722,6 +724,7 @@ Event::setUseValuesFromTriggerTime (bool value)
 int
 Event::unsetId ()
 {
+  updateParentIdIndex("");
   mId.erase();
 
   if (mId.empty())
@@ -743,6 +746,7 @@ Event::unsetName ()
 {
   if (getLevel() == 1) 
   {
+    updateParentIdIndex("");
     mId.erase();
   }
   else 
@@ -2256,19 +2260,6 @@ ListOfEvents::get(unsigned int n) const
 }
 
 
-/**
- * Used by ListOf::get() to lookup an SBase based by its id.
- */
-struct IdEqE : public unary_function<SBase*, bool>
-{
-  const string& mId;
-
-  IdEqE (const string& id) : mId(id) { }
-  bool operator() (SBase* sb) 
-       { return static_cast <Event *> (sb)->getId() == mId; }
-};
-
-
 /* return item by id */
 Event*
 ListOfEvents::get (const std::string& sid)
@@ -2282,10 +2273,7 @@ ListOfEvents::get (const std::string& sid)
 const Event*
 ListOfEvents::get (const std::string& sid) const
 {
-  vector<SBase*>::const_iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqE(sid) );
-  return (result == mItems.end()) ? NULL : static_cast <Event*> (*result);
+  return static_cast <const Event*> (getItemBySId(sid));
 }
 
 
@@ -2301,18 +2289,7 @@ ListOfEvents::remove (unsigned int n)
 Event*
 ListOfEvents::remove (const std::string& sid)
 {
-  SBase* item = NULL;
-  vector<SBase*>::iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqE(sid) );
-
-  if (result != mItems.end())
-  {
-    item = *result;
-    mItems.erase(result);
-  }
-
-  return static_cast <Event*> (item);
+  return static_cast <Event*> (removeItemBySId(sid));
 }
 
 
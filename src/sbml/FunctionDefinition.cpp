@@ -234,6 +234,7 @@ FunctionDefinition::setId (const std::string& sid)
   }
   else
   {
+    updateParentIdIndex(sid);
     mId = sid;
     return LIBSBML_OPERATION_SUCCESS;
   }
@@ -257,6 +258,7 @@ FunctionDefinition::setName (const std::string& name)
     }
     else
     {
+      updateParentIdIndex(name);
       mId = name;
       return LIBSBML_OPERATION_SUCCESS;
     }
@@ -307,6 +309,7 @@ FunctionDefinition::unsetName ()
 {
   if (getLevel() == 1) 
   {
+    updateParentIdIndex("");
     mId.erase();
   }
   else 
@@ -1239,19 +1242,6 @@ ListOfFunctionDefinitions::get(unsigned int n) const
 }
 
 
-/**
- * Used by ListOf::get() to lookup an SBase based by its id.
- */
-struct IdEqFD : public unary_function<SBase*, bool>
-{
-  const string& mId;
-
-  IdEqFD (const string& id) : mId(id) { }
-  bool operator() (SBase* sb) 
-       { return static_cast <FunctionDefinition *> (sb)->getId() == mId; }
-};
-
-
 /* return item by id */
 FunctionDefinition*
 ListOfFunctionDefinitions::get (const std::string& sid)
@@ -1265,12 +1255,7 @@ ListOfFunctionDefinitions::get (const std::string& sid)
 const FunctionDefinition*
 ListOfFunctionDefinitions::get (const std::string& sid) const
 {
-  vector<SBase*>::const_iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqFD(sid) );
-  return (result == mItems.end()) ? NULL : 
-                             static_cast <FunctionDefinition*> (*result);
-
+  return static_cast <const FunctionDefinition*> (getItemBySId(sid));
 }
 
 
@@ -1286,18 +1271,7 @@ ListOfFunctionDefinitions::remove (unsigned int n)
 FunctionDefinition*
 ListOfFunctionDefinitions::remove (const std::string& sid)
 {
-  SBase* item = NULL;
-  vector<SBase*>::iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqFD(sid) );
-
-  if (result != mItems.end())
-  {
-    item = *result;
-    mItems.erase(result);
-  }
-
-  return static_cast <FunctionDefinition*> (item);
+  return static_cast <FunctionDefinition*> (removeItemBySId(sid));
 }
 
 
@@ -36,6 +36,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <map>
 
 #include <sbml/SBMLVisitor.h>
 #include <sbml/ListOf.h>
@@ -43,6 +44,7 @@
 #include <sbml/common/common.h>
 #include <sbml/util/ElementFilter.h>
 #include <sbml/extension/SBasePlugin.h>
+#include <sbml/util/ThreadSupport.h>
 
 /** @cond doxygenIgnored */
 using namespace std;
@@ -51,15 +53,41 @@ using namespace std;
 LIBSBML_CPP_NAMESPACE_BEGIN
 #ifdef __cplusplus
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * The identifier index of a ListOf.  Lookups may happen concurrently from
+ * several threads (reading is not modifying), so the index is (re)built
+ * under the mutex and published by storing the revision of the items it
+ * reflects.
+ */
+struct ListOf::IdIndex
+{
+  IdIndex() : revision(0) {}
+
+  std::map<std::string, SBase*> ids;
+
+  /* revision of mItems the ids reflect; 0 if not built */
+  AtomicRevision revision;
+
+  Mutex mutex;
+};
+/** @endcond */
+
+
 /*
  * Creates a new ListOf items.
  */
 ListOf::ListOf (unsigned int level, unsigned int version)
 : SBase(level,version)
+, mItems (this)
 , mExplicitlyListed (false)
+, mIdIndex (new IdIndex())
 {
     if (!hasValidLevelVersionNamespaceCombination())
-    throw SBMLConstructorException();
+    {
+      delete mIdIndex;
+      throw SBMLConstructorException();
+    }
 }
 
 
@@ -68,10 +96,15 @@ ListOf::ListOf (unsigned int level, unsigned int version)
  */
 ListOf::ListOf (SBMLNamespaces* sbmlns)
 : SBase(sbmlns)
+, mItems (this)
 , mExplicitlyListed (false)
+, mIdIndex (new IdIndex())
 {
     if (!hasValidLevelVersionNamespaceCombination())
-    throw SBMLConstructorException();
+    {
+      delete mIdIndex;
+      throw SBMLConstructorException();
+    }
 }
 
 
@@ -90,6 +123,7 @@ struct Delete : public unary_function<SBase*, void>
 ListOf::~ListOf ()
 {
   for_each( mItems.begin(), mItems.end(), Delete() );
+  delete mIdIndex;
 }
 
 
@@ -105,7 +139,8 @@ struct Clone : public unary_function<SBase*, SBase*>
 /*
  * Copy constructor. Creates a copy of this ListOf items.
  */
-ListOf::ListOf (const ListOf& orig) : SBase(orig), mItems()
+ListOf::ListOf (const ListOf& orig) : SBase(orig), mItems(this)
+, mIdIndex (new IdIndex())
 {
   mItems.resize( orig.size() );
   transform( orig.mItems.begin(), orig.mItems.end(), mItems.begin(), Clone() );
@@ -172,22 +207,25 @@ int
 ListOf::insertAndOwn(int location, SBase* item)
 {
   /* no list elements yet */
-  if (this->getItemTypeCode() == SBML_UNKNOWN )
-  {
-    mItems.insert( mItems.begin() + location, item );
-    item->connectToParent(this);
-    return LIBSBML_OPERATION_SUCCESS;
-  }
-  else if (!isValidTypeForList(item))
+  if (this->getItemTypeCode() != SBML_UNKNOWN && !isValidTypeForList(item))
   {
     return LIBSBML_INVALID_OBJECT;
   }
-  else
+
+  bool current = (mIdIndex->revision.load() == mItems.getRevision());
+  mItems.insert( mItems.begin() + location, item );
+  item->connectToParent(this);
+
+  // an item inserted in front of others may take over their identifier
+  if (current)
   {
-    mItems.insert( mItems.begin() + location, item );
-    item->connectToParent(this);
-    return LIBSBML_OPERATION_SUCCESS;
+    if (item->isSetId())
+    {
+      reindexId(item->getId(), NULL);
+    }
+    mIdIndex->revision.store(mItems.getRevision());
   }
+  return LIBSBML_OPERATION_SUCCESS;
 }
 
 /*
@@ -214,22 +252,25 @@ int
 ListOf::appendAndOwn (SBase* item)
 {
   /* no list elements yet */
-  if (this->getItemTypeCode() == SBML_UNKNOWN )
-  {
-    mItems.push_back( item );
-    item->connectToParent(this);
-    return LIBSBML_OPERATION_SUCCESS;
-  }
-  else if (!isValidTypeForList(item))
+  if (this->getItemTypeCode() != SBML_UNKNOWN && !isValidTypeForList(item))
   {
     return LIBSBML_INVALID_OBJECT;
   }
-  else
+
+  bool current = (mIdIndex->revision.load() == mItems.getRevision());
+  mItems.push_back( item );
+  item->connectToParent(this);
+
+  // an appended item never displaces an earlier one with the same id
+  if (current)
   {
-    mItems.push_back( item );
-    item->connectToParent(this);
-    return LIBSBML_OPERATION_SUCCESS;
+    if (item->isSetId())
+    {
+      mIdIndex->ids.insert(make_pair(item->getId(), item));
+    }
+    mIdIndex->revision.store(mItems.getRevision());
   }
+  return LIBSBML_OPERATION_SUCCESS;
 }
 
 int ListOf::appendFrom(const ListOf* list)
@@ -266,6 +307,143 @@ ListOf::get (unsigned int n)
 }
 
 
+/*
+ * @return the first item in this ListOf with the given id, or NULL.
+ */
+const SBase*
+ListOf::getItemBySId (const std::string& sid) const
+{
+  if (!sid.empty())
+  {
+    if (mIdIndex->revision.load() != mItems.getRevision())
+    {
+      // items were added or removed since the index was built
+      MutexLock lock(mIdIndex->mutex);
+      if (mIdIndex->revision.load() != mItems.getRevision())
+      {
+        buildIdIndex();
+      }
+    }
+
+    map<string, SBase*>::const_iterator it = mIdIndex->ids.find(sid);
+    if (it == mIdIndex->ids.end())
+    {
+      return NULL;
+    }
+    else if (it->second->getId() == sid)
+    {
+      return it->second;
+    }
+
+    // the id was changed without telling us (e.g., by a package class
+    // writing the attribute directly); fall back on searching the list
+  }
+
+  ListItem::const_iterator result =
+    find_if(mItems.begin(), mItems.end(), IdEq<SBase>(sid));
+  return (result == mItems.end()) ? NULL : *result;
+}
+
+
+/*
+ * @return the first item in this ListOf with the given id, or NULL.
+ */
+SBase*
+ListOf::getItemBySId (const std::string& sid)
+{
+  return const_cast<SBase*>(
+    static_cast<const ListOf&>(*this).getItemBySId(sid) );
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+void
+ListOf::updateIdIndex (const SBase* item, const std::string& oldid,
+                       const std::string& newid)
+{
+  if (oldid == newid ||
+      mIdIndex->revision.load() != mItems.getRevision())
+  {
+    // nothing changes, or not built (or already out of date)
+    return;
+  }
+
+  // the index only ever references items of this list, so finding the item
+  // under its old id proves that it is one of ours, as does it being the
+  // last item (the usual create-then-setId case); otherwise let the next
+  // lookup rebuild the index
+  map<string, SBase*>::iterator old =
+    oldid.empty() ? mIdIndex->ids.end() : mIdIndex->ids.find(oldid);
+  if ((old == mIdIndex->ids.end() || old->second != item) &&
+      (mItems.empty() || mItems.back() != item))
+  {
+    mIdIndex->revision.store(0);
+    return;
+  }
+
+  if (!oldid.empty())
+  {
+    reindexId(oldid, item);
+  }
+
+  if (!newid.empty())
+  {
+    map<string, SBase*>::iterator it = mIdIndex->ids.find(newid);
+    if (it == mIdIndex->ids.end())
+    {
+      mIdIndex->ids.insert(make_pair(newid, const_cast<SBase*>(item)));
+    }
+    else
+    {
+      // duplicate id: the entry must reference whichever item comes first
+      for (ListItem::const_iterator i = mItems.begin(); i != mItems.end(); ++i)
+      {
+        if (*i == it->second) break;
+        if (*i == item)
+        {
+          it->second = const_cast<SBase*>(item);
+          break;
+        }
+      }
+    }
+  }
+}
+
+
+void
+ListOf::buildIdIndex () const
+{
+  mIdIndex->ids.clear();
+
+  // insert() keeps the first item for duplicated ids, as find_if would
+  for (ListItem::const_iterator it = mItems.begin(); it != mItems.end(); ++it)
+  {
+    const std::string& id = (*it)->getId();
+    if (!id.empty())
+    {
+      mIdIndex->ids.insert(make_pair(id, *it));
+    }
+  }
+  mIdIndex->revision.store(mItems.getRevision());
+}
+
+
+void
+ListOf::reindexId (const std::string& sid, const SBase* ignore)
+{
+  for (ListItem::const_iterator it = mItems.begin(); it != mItems.end(); ++it)
+  {
+    if (*it != ignore && (*it)->getId() == sid)
+    {
+      mIdIndex->ids[sid] = *it;
+      return;
+    }
+  }
+  mIdIndex->ids.erase(sid);
+}
+/** @endcond */
+
+
 SBase*
 ListOf::getElementBySId(const std::string& id)
 {
@@ -398,11 +576,39 @@ SBase*
 ListOf::remove (unsigned int n)
 {
   SBase* item = get(n);
-  if (item != NULL) mItems.erase( mItems.begin() + n );
+  if (item != NULL)
+  {
+    bool current = (mIdIndex->revision.load() == mItems.getRevision());
+    mItems.erase( mItems.begin() + n );
+
+    if (current)
+    {
+      if (item->isSetId())
+      {
+        reindexId(item->getId(), item);
+      }
+      mIdIndex->revision.store(mItems.getRevision());
+    }
+  }
   return item;
 }
 
 
+/*
+ * Removes the first item with the given id from this ListOf and returns
+ * it, or returns NULL if there is no such item.
+ */
+SBase*
+ListOf::removeItemBySId (const std::string& sid)
+{
+  SBase* item = getItemBySId(sid);
+  if (item == NULL) return NULL;
+
+  ListItemIter it = find(mItems.begin(), mItems.end(), item);
+  return remove((unsigned int)(it - mItems.begin()));
+}
+
+
 /*
  * Removes item in this ListOf items with the given @p id or @c NULL if no such
  * item exists.  The caller owns the returned item and is repsonsible for
@@ -92,6 +92,7 @@
 
 
 #include <vector>
+#include <string>
 #include <algorithm>
 #include <functional>
 
@@ -604,11 +605,136 @@ public:
 
 
   /** @endcond */
+
+
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Returns the item in this ListOf whose identifier is @p sid.
+   *
+   * Unlike getElementBySId(), only the direct children of this ListOf are
+   * considered.  The lookup goes through an identifier index that is built
+   * the first time this method is called and that is kept up to date by
+   * the methods adding or removing items, and by the setId() methods of
+   * the items themselves.  Repeated lookups therefore do not need to scan
+   * the whole list.
+   *
+   * @param sid the identifier of the item to retrieve.
+   *
+   * @return the first item with the given identifier, or @c NULL if no
+   * such item exists.
+   */
+  SBase* getItemBySId (const std::string& sid);
+
+
+  /**
+   * Returns the item in this ListOf whose identifier is @p sid.
+   *
+   * @param sid the identifier of the item to retrieve.
+   *
+   * @return the first item with the given identifier, or @c NULL if no
+   * such item exists.
+   *
+   * @see getItemBySId(const std::string& sid)
+   */
+  const SBase* getItemBySId (const std::string& sid) const;
+
+
+  /**
+   * Removes the first item in this ListOf whose identifier is @p sid and
+   * returns it.  The caller owns the returned item and is responsible for
+   * deleting it.
+   *
+   * @param sid the identifier of the item to remove.
+   *
+   * @return the removed item, or @c NULL if no such item exists.
+   */
+  SBase* removeItemBySId (const std::string& sid);
+
+
+  /**
+   * Informs this ListOf that the identifier of @p item is about to change
+   * from @p oldid to @p newid.  Invoked by the items of this list before
+   * their identifier is modified, so that the identifier index stays
+   * current.
+   */
+  void updateIdIndex (const SBase* item, const std::string& oldid,
+                      const std::string& newid);
+  /** @endcond */
+
+
 protected:
   /** @cond doxygenLibsbmlInternal */
-  typedef std::vector<SBase*>           ListItem;
+  /*
+   * The items of a ListOf.  This is a std::vector that counts the changes
+   * made to its contents, so that the identifier index can tell whether it
+   * is still current no matter which class added or removed the items.
+   */
+  class ListItem : public std::vector<SBase*>
+  {
+  public:
+    explicit ListItem (ListOf* owner) : mOwner(owner), mRevision(1) {}
+
+    unsigned long getRevision () const { return mRevision; }
+
+    void push_back (SBase* item)
+    {
+      std::vector<SBase*>::push_back(item);
+      changed();
+    }
+
+    iterator insert (iterator pos, SBase* item)
+    {
+      iterator it = std::vector<SBase*>::insert(pos, item);
+      changed();
+      return it;
+    }
+
+    iterator erase (iterator pos)
+    {
+      // the item leaves the list, which may well be deleted before it is
+      (*pos)->connectToParent(NULL);
+      iterator it = std::vector<SBase*>::erase(pos);
+      changed();
+      return it;
+    }
+
+    iterator erase (iterator first, iterator last)
+    {
+      iterator it = std::vector<SBase*>::erase(first, last);
+      changed();
+      return it;
+    }
+
+    void clear ()
+    {
+      std::vector<SBase*>::clear();
+      changed();
+    }
+
+    void resize (size_type n)
+    {
+      std::vector<SBase*>::resize(n);
+      changed();
+    }
+
+  private:
+    void changed ()
+    {
+      ++mRevision;
+      mOwner->invalidateModelIdIndex();
+    }
+
+    ListItem (const ListItem&);
+    ListItem& operator= (const ListItem&);
+
+    ListOf*       mOwner;
+    unsigned long mRevision;
+  };
+
   typedef std::vector<SBase*>::iterator ListItemIter;
 
+  struct IdIndex;
+
   /**
    * Subclasses should override this method to get the list of
    * expected attributes.
@@ -641,10 +767,27 @@ protected:
   virtual bool isValidTypeForList(SBase * item);
 
 
+  /**
+   * (Re)builds the identifier index from the current items.  The caller
+   * must hold the lock of the index.
+   */
+  void buildIdIndex () const;
+
+
+  /**
+   * Makes the index entry for @p sid point to the first item carrying that
+   * identifier, ignoring @p ignore, or removes the entry if there is none.
+   */
+  void reindexId (const std::string& sid, const SBase* ignore);
+
+
   ListItem mItems;
 
   bool mExplicitlyListed;
 
+  /* identifier -> first item with that identifier, built on first use */
+  IdIndex* mIdIndex;
+
   /** @endcond */
 };
 
@@ -690,19 +690,6 @@ ListOfLocalParameters::get(unsigned int n) const
 }
 
 
-/**
- * Used by ListOf::get() to lookup an SBase based by its id.
- */
-struct IdEqP : public unary_function<SBase*, bool>
-{
-  const string& mId;
-
-  IdEqP (const string& id) : mId(id) { }
-  bool operator() (SBase* sb) 
-       { return static_cast <LocalParameter *> (sb)->getId() == mId; }
-};
-
-
 /* return item by id */
 LocalParameter*
 ListOfLocalParameters::get (const std::string& sid)
@@ -716,12 +703,7 @@ ListOfLocalParameters::get (const std::string& sid)
 const LocalParameter*
 ListOfLocalParameters::get (const std::string& sid) const
 {
-  vector<SBase*>::const_iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqP(sid) );
-  return (result == mItems.end()) ? NULL : 
-                           static_cast <LocalParameter*> (*result);
-  
+  return static_cast <const LocalParameter*> (getItemBySId(sid));
 }
 
 
@@ -751,18 +733,7 @@ ListOfLocalParameters::remove (unsigned int n)
 LocalParameter*
 ListOfLocalParameters::remove (const std::string& sid)
 {
-  SBase* item = NULL;
-  vector<SBase*>::iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqP(sid) );
-
-  if (result != mItems.end())
-  {
-    item = *result;
-    mItems.erase(result);
-  }
-
-  return static_cast <LocalParameter*> (item);
+  return static_cast <LocalParameter*> (removeItemBySId(sid));
 }
 
 
@@ -57,10 +57,13 @@
 #include <sbml/AssignmentRule.h>
 #include <sbml/RateRule.h>
 
+#include <sbml/units/FormulaUnitsCache.h>
+
 #include <sbml/util/IdentifierTransformer.h>
 #include <sbml/util/ElementFilter.h>
 #include <sbml/util/IdFilter.h>
 #include <sbml/util/MetaIdFilter.h>
+#include <sbml/util/ThreadSupport.h>
 
 #include <sbml/extension/SBMLExtensionRegistry.h>
 #include <sbml/extension/SBasePlugin.h>
@@ -74,6 +77,37 @@ using namespace std;
 LIBSBML_CPP_NAMESPACE_BEGIN
 #ifdef __cplusplus
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * The index used by Model::getElementBySId().  Writers bump 'changes'
+ * whenever an element is added, removed or renamed; readers rebuild the
+ * index under the mutex when 'revision' (the value of 'changes' the ids
+ * reflect) no longer matches.
+ *
+ * Rebuilding costs about as much as a handful of searches, so a model that
+ * is modified between look-ups (e.g., by a converter) is searched directly
+ * until STALE_LOOKUPS look-ups have been made since the last rebuild.
+ */
+static const unsigned int STALE_LOOKUPS = 8;
+
+struct Model::ElementIdIndex
+{
+  ElementIdIndex() : changes(1), revision(0), staleLookups(0) {}
+
+  std::map<std::string, SBase*> ids;
+
+  unsigned long changes;
+
+  AtomicRevision revision;
+
+  /* guarded by mutex */
+  unsigned int staleLookups;
+
+  Mutex mutex;
+};
+/** @endcond */
+
+
 Model::Model (unsigned int level, unsigned int version) :
    SBase ( level, version )
  , mSubstanceUnits   ( "" )
@@ -83,6 +117,7 @@ Model::Model (unsigned int level, unsigned int version) :
  , mLengthUnits      ( "" )
  , mExtentUnits      ( "" )
  , mConversionFactor ( "" )
+ , mElementIdIndex   ( new ElementIdIndex() )
  , mFunctionDefinitions (level,version)
  , mUnitDefinitions     (level,version)
  , mCompartmentTypes    (level,version)
@@ -96,12 +131,16 @@ Model::Model (unsigned int level, unsigned int version) :
  , mReactions           (level,version)
  , mEvents              (level,version)
  , mFormulaUnitsData ( NULL  )
+ , mFormulaUnitsCache ( NULL )
  , mIdList (  )
  , mMetaidList ( )
  , mUnitsDataMap ()
 {
   if (!hasValidLevelVersionNamespaceCombination())
+  {
+    delete mElementIdIndex;
     throw SBMLConstructorException();
+  }
 
   connectToChild();
 }
@@ -116,6 +155,7 @@ Model::Model (SBMLNamespaces * sbmlns) :
  , mLengthUnits      ( "" )
  , mExtentUnits      ( "" )
  , mConversionFactor ( "" )
+ , mElementIdIndex   ( new ElementIdIndex() )
  , mFunctionDefinitions (sbmlns)
  , mUnitDefinitions     (sbmlns)
  , mCompartmentTypes    (sbmlns)
@@ -129,12 +169,14 @@ Model::Model (SBMLNamespaces * sbmlns) :
  , mReactions           (sbmlns)
  , mEvents              (sbmlns)
  , mFormulaUnitsData ( NULL  )
+ , mFormulaUnitsCache ( NULL )
  , mIdList (  )
  , mMetaidList ( )
  , mUnitsDataMap ()
 {
   if (!hasValidLevelVersionNamespaceCombination())
   {
+    delete mElementIdIndex;
     throw SBMLConstructorException(getElementName(), sbmlns);
   }
 
@@ -159,8 +201,13 @@ Model::~Model ()
     }
     delete mFormulaUnitsData;
   }
+  delete mFormulaUnitsCache;
   mEvents.clear();
   mUnitsDataMap.clear();
+
+  // the items destroyed with the lists below need not report to the index
+  delete mElementIdIndex;
+  mElementIdIndex = NULL;
 }
 
 
@@ -176,6 +223,7 @@ Model::Model(const Model& orig)
   , mLengthUnits         (orig.mLengthUnits)
   , mExtentUnits         (orig.mExtentUnits)
   , mConversionFactor    (orig.mConversionFactor)
+  , mElementIdIndex      (new ElementIdIndex())
   , mFunctionDefinitions (orig.mFunctionDefinitions)
   , mUnitDefinitions     (orig.mUnitDefinitions)
   , mCompartmentTypes    (orig.mCompartmentTypes)
@@ -189,6 +237,7 @@ Model::Model(const Model& orig)
   , mReactions           (orig.mReactions)
   , mEvents              (orig.mEvents)
   , mFormulaUnitsData    (NULL)
+  , mFormulaUnitsCache   (NULL)
   , mIdList              (orig.mIdList)
   , mMetaidList          (orig.mMetaidList)
   , mUnitsDataMap        ()
@@ -210,6 +259,10 @@ Model::Model(const Model& orig)
       mUnitsDataMap.insert(make_pair(key, newFud));
     }
   }
+  if (orig.mFormulaUnitsCache != NULL)
+  {
+    mFormulaUnitsCache = new FormulaUnitsCache(*orig.mFormulaUnitsCache);
+  }
   connectToChild();
   
 }
@@ -275,6 +328,13 @@ Model& Model::operator=(const Model& rhs)
       this->mFormulaUnitsData = NULL;
       mUnitsDataMap.clear();
     }
+
+    delete mFormulaUnitsCache;
+    mFormulaUnitsCache = NULL;
+    if (rhs.mFormulaUnitsCache != NULL)
+    {
+      mFormulaUnitsCache = new FormulaUnitsCache(*rhs.mFormulaUnitsCache);
+    }
   }
 
   mIdList     = rhs.mIdList;
@@ -325,6 +385,186 @@ SBase*
 Model::getElementBySId(const std::string& id)
 {
   if (id.empty()) return NULL;
+
+  if (mElementIdIndex->revision.load() != mElementIdIndex->changes)
+  {
+    bool rebuilt = true;
+    {
+      MutexLock lock(mElementIdIndex->mutex);
+      if (mElementIdIndex->revision.load() != mElementIdIndex->changes)
+      {
+        rebuilt = (++mElementIdIndex->staleLookups >= STALE_LOOKUPS);
+        if (rebuilt)
+        {
+          buildElementIdIndex();
+        }
+      }
+    }
+
+    if (!rebuilt)
+    {
+      return findElementBySId(id);
+    }
+  }
+
+  map<string, SBase*>::const_iterator it = mElementIdIndex->ids.find(id);
+  if (it != mElementIdIndex->ids.end() && it->second->getId() == id)
+  {
+    return it->second;
+  }
+
+  // not (or no longer) indexed: elements attached without going through
+  // a ListOf, or whose id was written directly, are only found this way
+  return findElementBySId(id);
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+void
+Model::invalidateElementIdIndex()
+{
+  if (mElementIdIndex != NULL)
+  {
+    ++mElementIdIndex->changes;
+  }
+}
+
+
+/*
+ * Collects the elements findElementBySId() can return, in the order it
+ * visits them, so that the first element carrying an id is the one indexed.
+ *
+ * Which ids a container searches is decided by its own getElementBySId()
+ * (unit definitions, local parameters, rules, ports, ... are not in the SId
+ * namespace), so rather than duplicating those rules each container is
+ * asked: a ListOf once, with the id of one of its items, and any other
+ * parent with the id of the child in question.  Elements left out this way
+ * are still found by the search that getElementBySId() falls back on.
+ */
+class ElementIdIndexBuilder
+{
+public:
+  ElementIdIndexBuilder (Model& model, map<string, SBase*>& ids)
+    : mModel(model), mIds(ids)
+  {
+  }
+
+  /* one of the lists of the model: its items, then all below them */
+  void addList (ListOf& list)
+  {
+    bool searched = searchesItemIds(list);
+    for (unsigned int i = 0; i < list.size(); ++i)
+    {
+      SBase* item = list.get(i);
+      if (searched) add(item);
+      addAll(item->getAllElements());
+    }
+    addAll(list.getAllElementsFromPlugins());
+  }
+
+  void addAll (List* elements)
+  {
+    for (ListIterator it = elements->begin(); it != elements->end(); ++it)
+    {
+      SBase* element = static_cast<SBase*>(*it);
+      if (element->isSetId() && isSearched(element))
+      {
+        add(element);
+      }
+    }
+    delete elements;
+  }
+
+private:
+  void add (SBase* element)
+  {
+    if (element->isSetId())
+    {
+      mIds.insert(make_pair(element->getId(), element));
+    }
+  }
+
+  bool isSearched (SBase* element)
+  {
+    SBase* parent = element->getParentSBMLObject();
+    const string& id = element->getId();
+
+    if (parent == &mModel)
+    {
+      return mModel.getElementFromPluginsBySId(id) == element;
+    }
+    else if (parent != NULL && parent->getTypeCode() == SBML_LIST_OF)
+    {
+      ListOf* list = static_cast<ListOf*>(parent);
+      if (element->getTypeCode() == list->getItemTypeCode())
+      {
+        return searchesItemIds(*list);
+      }
+      return list->getElementFromPluginsBySId(id) == element;
+    }
+    return parent != NULL && parent->getElementBySId(id) == element;
+  }
+
+  bool searchesItemIds (ListOf& list)
+  {
+    map<const ListOf*, bool>::const_iterator known = mSearched.find(&list);
+    if (known != mSearched.end())
+    {
+      return known->second;
+    }
+
+    bool searched = false;
+    for (unsigned int i = 0; i < list.size(); ++i)
+    {
+      SBase* item = list.get(i);
+      if (item->isSetId())
+      {
+        searched = (list.getElementBySId(item->getId()) == item);
+        break;
+      }
+    }
+    mSearched[&list] = searched;
+    return searched;
+  }
+
+  Model&                   mModel;
+  map<string, SBase*>&     mIds;
+  map<const ListOf*, bool> mSearched;
+};
+
+
+void
+Model::buildElementIdIndex()
+{
+  map<string, SBase*>& ids = mElementIdIndex->ids;
+  ids.clear();
+
+  ElementIdIndexBuilder builder(*this, ids);
+  builder.addList(mFunctionDefinitions);
+  builder.addList(mUnitDefinitions);
+  builder.addList(mCompartmentTypes);
+  builder.addList(mSpeciesTypes);
+  builder.addList(mCompartments);
+  builder.addList(mSpecies);
+  builder.addList(mParameters);
+  builder.addList(mReactions);
+  builder.addList(mInitialAssignments);
+  builder.addList(mRules);
+  builder.addList(mConstraints);
+  builder.addList(mEvents);
+  builder.addAll(getAllElementsFromPlugins());
+
+  mElementIdIndex->staleLookups = 0;
+  mElementIdIndex->revision.store(mElementIdIndex->changes);
+}
+
+
+/*
+ * Searches the whole model, in the order getElementBySId() promises.
+ */
+SBase*
+Model::findElementBySId(const std::string& id)
+{
   SBase* obj = mFunctionDefinitions.getElementBySId(id);
   if (obj != NULL) return obj;
   obj = mUnitDefinitions.getElementBySId(id);
@@ -352,6 +592,7 @@ Model::getElementBySId(const std::string& id)
 
   return getElementFromPluginsBySId(id);
 }
+/** @endcond */
 
 
 SBase*
@@ -5706,7 +5947,14 @@ Model::populateListFormulaUnitsData()
   /* create the units data from math elements */
 
   // pass the unitFormatter as this will save data
-  // for math expressions already evaluated
+  // for math expressions already evaluated; the cache keeps the units
+  // of math whose units cannot have changed since the last call
+
+  if (mFormulaUnitsCache == NULL)
+  {
+    mFormulaUnitsCache = new FormulaUnitsCache();
+  }
+  mFormulaUnitsCache->begin(this);
 
   createInitialAssignmentUnitsData(unitFormatter);
   createConstraintUnitsData(unitFormatter);
@@ -5714,6 +5962,8 @@ Model::populateListFormulaUnitsData()
   createReactionUnitsData(unitFormatter);
   createEventUnitsData(unitFormatter);
 
+  mFormulaUnitsCache->end();
+
   delete unitFormatter;
 }
 /** @endcond */
@@ -6659,21 +6909,7 @@ void
 Model::createUnitsDataFromMath(UnitFormulaFormatter * unitFormatter,
                                FormulaUnitsData *fud, const ASTNode * math)
 {
-  UnitDefinition * ud = NULL;
-  
-  if (math != NULL)
-  {
-    unitFormatter->resetFlags();
-    ud = unitFormatter->getUnitDefinition(math);
-    
-    fud->setContainsParametersWithUndeclaredUnits
-                              (unitFormatter->getContainsUndeclaredUnits());
-    fud->setCanIgnoreUndeclaredUnits
-                                (unitFormatter->canIgnoreUndeclaredUnits());
-    fud->setContainsInconsistency(unitFormatter->getContainsInconsistentUnits());
-  }
-
-  fud->setUnitDefinition(ud);
+  mFormulaUnitsCache->setUnits(fud, math, unitFormatter);
 }
 /** @endcond */
 
@@ -6765,7 +7001,6 @@ Model::createRuleUnitsData(UnitFormulaFormatter * unitFormatter)
 void
 Model::createReactionUnitsData(UnitFormulaFormatter * unitFormatter)
 {
-  UnitDefinition *ud = NULL;
   FormulaUnitsData *fud = NULL;
   
   for (unsigned int n=0; n < getNumReactions(); n++)
@@ -6788,20 +7023,11 @@ Model::createReactionUnitsData(UnitFormulaFormatter * unitFormatter)
 
       //fud->setComponentTypecode(SBML_KINETIC_LAW);
 
-      // have to use the old way for now as unitFormatter needs to know
-      // if we are in a reaction so it can access localParameters
-      unitFormatter->resetFlags();
-      if(react->getKineticLaw()->isSetMath())
-      {
-        ud = unitFormatter->getUnitDefinition
-                                  (react->getKineticLaw()->getMath(), true, (int)n);
-        fud->setContainsParametersWithUndeclaredUnits
-                                 (unitFormatter->getContainsUndeclaredUnits());
-        fud->setCanIgnoreUndeclaredUnits
-                                   (unitFormatter->canIgnoreUndeclaredUnits());
-      }
-
-      fud->setUnitDefinition(ud);
+      // the unitFormatter needs to know if we are in a reaction
+      // so it can access localParameters
+      KineticLaw* kl = react->getKineticLaw();
+      mFormulaUnitsCache->setUnits(fud, kl->isSetMath() ? kl->getMath() : NULL,
+                                   unitFormatter, kl, (int)n);
 
       createLocalParameterUnitsData(react->getKineticLaw(), unitFormatter);
     }
@@ -7280,6 +7506,15 @@ Model::getListFormulaUnitsData () const
 /** @endcond */
 
 
+/** @cond doxygenLibsbmlInternal */
+const FormulaUnitsCache*
+Model::getFormulaUnitsCache () const
+{
+  return mFormulaUnitsCache;
+}
+/** @endcond */
+
+
 /** @cond doxygenLibsbmlInternal */
 /*
  * returns true if the list has been populated, false otherwise
@@ -468,6 +468,7 @@ LIBSBML_CPP_NAMESPACE_BEGIN
 
 class SBMLVisitor;
 class FormulaUnitsData;
+class FormulaUnitsCache;
 class UnitFormulaFormatter;
 class ElementFilter;
 
@@ -3676,6 +3677,16 @@ public:
    */
   const List* getListFormulaUnitsData () const;
 
+
+  /**
+   * Get the cache of units derived from math, which
+   * populateListFormulaUnitsData() keeps between calls.
+   *
+   * @return the cache, or @c NULL if the list of FormulaUnitsData has
+   * never been populated.
+   */
+  const FormulaUnitsCache* getFormulaUnitsCache () const;
+
   
   /** @endcond */
 
@@ -4174,6 +4185,15 @@ public:
   /** @endcond */
 
 
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Marks the index used by getElementBySId() as out of date.  Invoked
+   * whenever elements of this Model are added, removed or renamed.
+   */
+  void invalidateElementIdIndex();
+  /** @endcond */
+
+
 protected:
   /** @cond doxygenLibsbmlInternal */
   /**
@@ -4236,6 +4256,21 @@ protected:
    */
   virtual void syncAnnotation();
 
+  struct ElementIdIndex;
+
+  /**
+   * (Re)builds the index used by getElementBySId().  The caller must hold
+   * the lock of the index.
+   */
+  void buildElementIdIndex();
+
+
+  /**
+   * Searches this Model for the first element with the given id, without
+   * using the index.
+   */
+  SBase* findElementBySId(const std::string& id);
+
   //std::string     mId;
   //std::string     mName;
   std::string     mSubstanceUnits;
@@ -4246,6 +4281,8 @@ protected:
   std::string     mExtentUnits;
   std::string     mConversionFactor;
 
+  /* declared before the lists, so that it outlives their items */
+  ElementIdIndex *           mElementIdIndex;
 
   ListOfFunctionDefinitions  mFunctionDefinitions;
   ListOfUnitDefinitions      mUnitDefinitions;
@@ -4261,6 +4298,7 @@ protected:
   ListOfEvents               mEvents;
 
   List *                     mFormulaUnitsData;
+  FormulaUnitsCache *        mFormulaUnitsCache;
   IdList                     mIdList;
   IdList                     mMetaidList;
   UnitsValueMap              mUnitsDataMap;
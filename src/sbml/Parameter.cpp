@@ -344,6 +344,7 @@ Parameter::setId (const std::string& sid)
   }
   else
   {
+    updateParentIdIndex(sid);
     mId = sid;
     return LIBSBML_OPERATION_SUCCESS;
   }
@@ -367,6 +368,7 @@ Parameter::setName (const std::string& name)
     }
     else
     {
+      updateParentIdIndex(name);
       mId = name;
       return LIBSBML_OPERATION_SUCCESS;
     }
@@ -438,6 +440,7 @@ Parameter::unsetName ()
 {
   if (getLevel() == 1) 
   {
+    updateParentIdIndex("");
     mId.erase();
   }
   else 
@@ -1877,17 +1880,6 @@ ListOfParameters::get(unsigned int n) const
 }
 
 
-/**
- * Used by ListOf::get() to lookup an SBase based by its id.
- */
-struct IdEqP : public unary_function<SBase*, bool>
-{
-  const string& mId;
-
-  IdEqP (const string& id) : mId(id) { }
-  bool operator() (SBase* sb) 
-       { return static_cast <Parameter *> (sb)->getId() == mId; }
-};
 /* return item by id */
 Parameter*
 ListOfParameters::get (const std::string& sid)
@@ -1901,10 +1893,7 @@ ListOfParameters::get (const std::string& sid)
 const Parameter*
 ListOfParameters::get (const std::string& sid) const
 {
-  vector<SBase*>::const_iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqP(sid) );
-  return (result == mItems.end()) ? NULL : static_cast <Parameter*> (*result);
+  return static_cast <const Parameter*> (getItemBySId(sid));
 }
 
 
@@ -1920,18 +1909,7 @@ ListOfParameters::remove (unsigned int n)
 Parameter*
 ListOfParameters::remove (const std::string& sid)
 {
-  SBase* item = NULL;
-  vector<SBase*>::iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqP(sid) );
-
-  if (result != mItems.end())
-  {
-    item = *result;
-    mItems.erase(result);
-  }
-
-  return static_cast <Parameter*> (item);
+  return static_cast <Parameter*> (removeItemBySId(sid));
 }
 
 
@@ -530,6 +530,7 @@ Reaction::setId (const std::string& sid)
   }
   else
   {
+    updateParentIdIndex(sid);
     mId = sid;
     return LIBSBML_OPERATION_SUCCESS;
   }
@@ -553,6 +554,7 @@ Reaction::setName (const std::string& name)
     }
     else
     {
+      updateParentIdIndex(name);
       mId = name;
       return LIBSBML_OPERATION_SUCCESS;
     }
@@ -667,6 +669,7 @@ Reaction::unsetName ()
 {
   if (getLevel() == 1) 
   {
+    updateParentIdIndex("");
     mId.erase();
   }
   else 
@@ -2580,10 +2583,7 @@ ListOfReactions::get (const std::string& sid)
 const Reaction*
 ListOfReactions::get (const std::string& sid) const
 {
-  vector<SBase*>::const_iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEq<Reaction>(sid) );
-  return (result == mItems.end()) ? NULL : static_cast <Reaction*> (*result);
+  return static_cast <const Reaction*> (getItemBySId(sid));
 }
 
 
@@ -2599,19 +2599,7 @@ ListOfReactions::remove (unsigned int n)
 Reaction*
 ListOfReactions::remove (const std::string& sid)
 {
-  SBase* item = NULL;
-  vector<SBase*>::iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEq<Reaction>(sid) );
-
-  if (result != mItems.end())
-  {
-    item = *result;
-    mItems.erase(result);
-  }
-
-
-  return static_cast <Reaction*> (item);
+  return static_cast <Reaction*> (removeItemBySId(sid));
 }
 
 
@@ -142,6 +142,9 @@ SBMLDocument::SBMLDocument (unsigned int level, unsigned int version) :
  , mLocationURI     ("")
  , mRequiredAttrOfUnknownPkg()
  , mRequiredAttrOfUnknownDisabledPkg()
+ , mComponentHandler ( NULL )
+ , mHandedOverLists ()
+ , mComponentHandlerStopped ( false )
 {
   if (mLevel   == 0 && mVersion == 0)  
   {
@@ -176,6 +179,9 @@ SBMLDocument::SBMLDocument (SBMLNamespaces* sbmlns) :
  , mLocationURI ("")
  , mRequiredAttrOfUnknownPkg()
  , mRequiredAttrOfUnknownDisabledPkg()
+ , mComponentHandler ( NULL )
+ , mHandedOverLists ()
+ , mComponentHandlerStopped ( false )
 {
   if (!hasValidLevelVersionNamespaceCombination())
   {
@@ -270,6 +276,9 @@ SBMLDocument::SBMLDocument (const SBMLDocument& orig)
  , mRequiredAttrOfUnknownPkg(orig.mRequiredAttrOfUnknownPkg)
  , mRequiredAttrOfUnknownDisabledPkg(orig.mRequiredAttrOfUnknownDisabledPkg)
  , mPkgUseDefaultNSMap()
+ , mComponentHandler ( NULL )
+ , mHandedOverLists ()
+ , mComponentHandlerStopped ( false )
 {
   
   
@@ -278,6 +287,7 @@ SBMLDocument::SBMLDocument (const SBMLDocument& orig)
   mInternalValidator->setDocument(this);
   mInternalValidator->setApplicableValidators(orig.getApplicableValidators());
   mInternalValidator->setConversionValidators(orig.getConversionValidators());
+  mInternalValidator->setNumThreads(orig.getNumValidationThreads());
   
   if (orig.mModel != NULL) 
   {
@@ -576,6 +586,48 @@ SBMLDocument::setInvalidLevel()
   mVersion = 0;
 }
 
+
+bool
+SBMLDocument::handOverComponent(SBase* component)
+{
+  if (mComponentHandler == NULL || mModel == NULL || component == NULL)
+  {
+    return false;
+  }
+
+  SBase* parent = component->getParentSBMLObject();
+  if (parent == NULL || parent->getTypeCode() != SBML_LIST_OF
+    || parent->getParentSBMLObject() != mModel
+    || !mComponentHandler->handles(component))
+  {
+    return false;
+  }
+
+  ListOf* list = static_cast<ListOf*>(parent);
+  unsigned int n = list->size();
+  if (n == 0 || list->get(n - 1) != component)
+  {
+    return false;
+  }
+
+  if (mComponentHandler->handle(component) != LIBSBML_OPERATION_SUCCESS)
+  {
+    mComponentHandlerStopped = true;
+  }
+
+  mHandedOverLists.insert(list);
+  delete list->remove(n - 1);
+
+  return true;
+}
+
+
+bool
+SBMLDocument::hasHandedOverComponents(const SBase* list) const
+{
+  return mHandedOverLists.find(list) != mHandedOverLists.end();
+}
+
 /** @endcond */
 
 /** @cond doxygenLibsbmlInternal */
@@ -709,6 +761,20 @@ SBMLDocument::setConsistencyChecksForConversion(SBMLErrorCategory_t category,
 }
 
 
+void
+SBMLDocument::setNumValidationThreads(unsigned int numThreads)
+{
+  mInternalValidator->setNumThreads(numThreads);
+}
+
+
+unsigned int
+SBMLDocument::getNumValidationThreads() const
+{
+  return mInternalValidator->getNumThreads();
+}
+
+
 /*
  * Performs a set of semantic consistency checks on the document.  Query
  * the results by calling getNumErrors() and getError().
@@ -2494,6 +2560,24 @@ SBMLDocument_setConsistencyChecksForConversion(SBMLDocument_t * d,
 }
 
 
+LIBSBML_EXTERN
+void
+SBMLDocument_setNumValidationThreads(SBMLDocument_t * d,
+                                     unsigned int numThreads)
+{
+  if (d != NULL)
+    d->setNumValidationThreads(numThreads);
+}
+
+
+LIBSBML_EXTERN
+unsigned int
+SBMLDocument_getNumValidationThreads(const SBMLDocument_t * d)
+{
+  return (d != NULL) ? d->getNumValidationThreads() : 0;
+}
+
+
 LIBSBML_EXTERN
 unsigned int
 SBMLDocument_checkConsistency (SBMLDocument_t *d)
@@ -307,6 +307,7 @@
 
 #include <iosfwd>
 #include <map>
+#include <set>
 
 LIBSBML_CPP_NAMESPACE_BEGIN
 
@@ -318,6 +319,7 @@ class XMLError;
 class SBMLValidator;
 class SBMLInternalValidator;
 class SBMLLevelVersionConverter;
+class SBMLComponentHandler;
 
 /** @cond doxygenLibsbmlInternal */
 /* Internal constants for setting/unsetting particular consistency checks. */
@@ -973,6 +975,37 @@ public:
                                          bool apply);
 
 
+  /**
+   * Sets the number of threads that SBMLDocument::checkConsistency() may
+   * use for its core consistency checks.
+   *
+   * With more than one thread, the identifier, general, %SBO and MathML
+   * checks run at the same time, followed by the units, overdetermined
+   * model and modeling practice checks.  Each check works on its own copy
+   * of the document, and the failures are reported in the same order as
+   * with a single thread.  The checks of Level&nbsp;3 packages and those
+   * added with addValidator() still run one after the other.
+   *
+   * @param numThreads the number of threads.  The default, @c 1, runs
+   * all checks one after the other on this document.  The value is
+   * ignored if libSBML was built without thread support.
+   *
+   * @see getNumValidationThreads()
+   */
+  void setNumValidationThreads(unsigned int numThreads);
+
+
+  /**
+   * Returns the number of threads that SBMLDocument::checkConsistency()
+   * may use.
+   *
+   * @return the number of threads.
+   *
+   * @see setNumValidationThreads(@if java long@endif)
+   */
+  unsigned int getNumValidationThreads() const;
+
+
   /**
    * Performs consistency checking and validation on this SBML document.
    *
@@ -1688,6 +1721,24 @@ protected:
   void setInvalidLevel();
 
 
+  /*
+   * Passes the given component, which has just been read, to the
+   * component handler of the reader if it is a top-level component of the
+   * model the handler accepts.  The component is then removed from its
+   * list and deleted.
+   *
+   * @return @c true if the component was handed over (and deleted).
+   */
+  bool handOverComponent(SBase* component);
+
+
+  /*
+   * Returns @c true if components of the given list have been handed over
+   * while reading, so that the list being empty is not an error.
+   */
+  bool hasHandedOverComponents(const SBase* list) const;
+
+
 
   unsigned int mLevel;
   unsigned int mVersion;
@@ -1706,6 +1757,10 @@ protected:
 
   PkgUseDefaultNSMap       mPkgUseDefaultNSMap;
 
+  SBMLComponentHandler*    mComponentHandler;
+  std::set<const SBase*>   mHandedOverLists;
+  bool                     mComponentHandlerStopped;
+
   friend class SBase;
   friend class SBMLReader;
   friend class SBMLLevelVersionConverter;
@@ -2308,6 +2363,37 @@ SBMLDocument_setConsistencyChecksForConversion(SBMLDocument_t *d,
                                                SBMLErrorCategory_t category,
                                                int apply);
 
+
+/**
+ * Sets the number of threads that SBMLDocument_checkConsistency() may use.
+ *
+ * @param d the SBMLDocument_t structure.
+ *
+ * @param numThreads the number of threads; with the default, @c 1, all
+ * checks run one after the other.
+ *
+ * @memberof SBMLDocument_t
+ */
+LIBSBML_EXTERN
+void
+SBMLDocument_setNumValidationThreads(SBMLDocument_t *d,
+                                     unsigned int numThreads);
+
+
+/**
+ * Returns the number of threads that SBMLDocument_checkConsistency() may
+ * use.
+ *
+ * @param d the SBMLDocument_t structure.
+ *
+ * @return the number of threads, or @c 0 if @p d is @c NULL.
+ *
+ * @memberof SBMLDocument_t
+ */
+LIBSBML_EXTERN
+unsigned int
+SBMLDocument_getNumValidationThreads(const SBMLDocument_t *d);
+
 /**
  * Performs a set of consistency and validation checks on the given SBML
  * document.
@@ -154,6 +154,40 @@ SBMLReader::readSBMLFromString (const std::string& xml)
 }
 
 
+/*
+ * Reads an SBML document from the given filename, passing the top-level
+ * components of its model to the given handler.
+ */
+SBMLDocument*
+SBMLReader::readSBMLFromFile (const std::string& filename,
+                              SBMLComponentHandler& handler)
+{
+  return readInternal(filename.c_str(), true, &handler);
+}
+
+
+/*
+ * Reads an SBML document from the given XML string, passing the top-level
+ * components of its model to the given handler.
+ */
+SBMLDocument*
+SBMLReader::readSBMLFromString (const std::string& xml,
+                                SBMLComponentHandler& handler)
+{
+  const static string dummy_xml ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");  
+
+  if (!strncmp(xml.c_str(), dummy_xml.c_str(), 14))
+  {
+    return readInternal(xml.c_str(), false, &handler);
+  }
+  else
+  {
+    const std::string temp = (dummy_xml + xml);
+    return readInternal(temp.c_str(), false, &handler);
+  }
+}
+
+
 /*
  * Predicate returning @c true if
  * libSBML is linked with zlib.
@@ -180,6 +214,21 @@ SBMLReader::hasBzip2()
 }
 
 
+SBMLComponentHandler::~SBMLComponentHandler()
+{
+}
+
+
+/*
+ * By default every top-level component is handled.
+ */
+bool
+SBMLComponentHandler::handles(const SBase*)
+{
+  return true;
+}
+
+
 /** @cond doxygenLibsbmlInternal */
 static bool
 isCriticalError(const unsigned int errorId)
@@ -249,7 +298,8 @@ void sortReportedErrors(SBMLDocument* d)
  * Used by readSBML() and readSBMLFromString().
  */
 SBMLDocument*
-SBMLReader::readInternal (const char* content, bool isFile)
+SBMLReader::readInternal (const char* content, bool isFile,
+                          SBMLComponentHandler* handler)
 {
   SBMLDocument* d = new SBMLDocument();
   if (isFile) {
@@ -292,7 +342,10 @@ SBMLReader::readInternal (const char* content, bool isFile)
       return d;
     }
 	
+    d->mComponentHandler = handler;
     d->read(stream);
+    d->mComponentHandler = NULL;
+    d->mHandedOverLists.clear();
     
     if (stream.isError())
     {
@@ -337,7 +390,7 @@ SBMLReader::readInternal (const char* content, bool isFile)
                                      d->getLevel(), d->getVersion());
         }
       }
-      else if (d->getLevel() == 1)
+      else if (d->getLevel() == 1 && handler == NULL)
       {
 	// In Level 1, some listOfElements were required.
 
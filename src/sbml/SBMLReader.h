@@ -332,6 +332,56 @@ if (doc.getNumErrors() > 0)
 LIBSBML_CPP_NAMESPACE_BEGIN
 
 class SBMLDocument;
+class SBase;
+
+
+/**
+ * @class SBMLComponentHandler
+ * @sbmlbrief{core} Receives the components of a model while it is read.
+ *
+ * An SBMLComponentHandler passed to SBMLReader::readSBMLFromFile() or
+ * SBMLReader::readSBMLFromString() is given each top-level component of
+ * the model (a Species, a Reaction, etc.) as soon as it has been read
+ * completely.  A component the handler accepts is removed from the model
+ * and deleted once the handler returns, so only one of them is held in
+ * memory at a time.  Components the handler does not accept are kept in
+ * the model as usual.
+ */
+class LIBSBML_EXTERN SBMLComponentHandler
+{
+public:
+
+  virtual ~SBMLComponentHandler();
+
+
+  /**
+   * Returns @c true if the given component should be passed to handle()
+   * instead of being kept in the model.
+   *
+   * The default implementation accepts every component.
+   *
+   * @param component the component that has just been read.
+   *
+   * @return @c true to handle the component, @c false to keep it.
+   */
+  virtual bool handles(const SBase* component);
+
+
+  /**
+   * Processes a component that has just been read.
+   *
+   * The component is still connected to its ListOf in the model when this
+   * method is called, but it is deleted afterwards; clone it to keep it.
+   * In order to stop reading return a value other than
+   * LIBSBML_OPERATION_SUCCESS.
+   *
+   * @param component the component that has just been read.
+   *
+   * @return LIBSBML_OPERATION_SUCCESS to continue reading,
+   *         any other value to stop.
+   */
+  virtual int handle(SBase* component) = 0;
+};
 
 
 class LIBSBML_EXTERN SBMLReader
@@ -408,6 +458,43 @@ public:
   SBMLDocument* readSBMLFromString (const std::string& xml);
 
 
+  /**
+   * Reads the SBML file with the given name, passing each top-level
+   * component of its model to @p handler as soon as it has been read.
+   *
+   * Components accepted by the handler are not kept in the model of the
+   * returned document, so that a file too large to be held in memory can
+   * still be scanned.  Since the model is incomplete, the document
+   * returned should not be validated or written.
+   *
+   * @param filename the name or full pathname of the file to be read.
+   * @param handler the handler receiving the components.
+   *
+   * @return a pointer to the SBMLDocument object created from the SBML
+   * content in @p filename, without the components handled.
+   *
+   * @see SBMLComponentHandler
+   */
+  SBMLDocument* readSBMLFromFile (const std::string& filename,
+                                  SBMLComponentHandler& handler);
+
+
+  /**
+   * Reads SBML from the given XML string, passing each top-level component
+   * of its model to @p handler as soon as it has been read.
+   *
+   * @param xml a string containing a full SBML model.
+   * @param handler the handler receiving the components.
+   *
+   * @return a pointer to the SBMLDocument created from the SBML content,
+   * without the components handled.
+   *
+   * @see readSBMLFromFile(const std::string& filename, SBMLComponentHandler& handler)
+   */
+  SBMLDocument* readSBMLFromString (const std::string& xml,
+                                    SBMLComponentHandler& handler);
+
+
   /**
    * Static method; returns @c true if this copy of libSBML supports
    * <i>gzip</I> and <i>zip</i> format compression.
@@ -443,7 +530,8 @@ protected:
    *
    * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html@endif@~
    */
-  SBMLDocument* readInternal (const char* content, bool isFile = true);
+  SBMLDocument* readInternal (const char* content, bool isFile = true,
+                              SBMLComponentHandler* handler = NULL);
 
   /** @endcond */
 };
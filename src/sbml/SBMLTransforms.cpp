@@ -51,7 +51,7 @@ LIBSBML_CPP_NAMESPACE_BEGIN
 #ifdef __cplusplus
 
 /** @cond doxygenLibsbmlInternal */
-SBMLTransforms::IdValueMap SBMLTransforms::mValues;
+EvaluationContext SBMLTransforms::mContext;
 
 void
 SBMLTransforms::replaceFD(ASTNode * node, const ListOfFunctionDefinitions *lofd, const IdList* idsToExclude /*= NULL*/)
@@ -239,7 +239,7 @@ SBMLTransforms::nodeContainsNameNotInList(const ASTNode * node, IdList& ids)
 IdList 
 SBMLTransforms::mapComponentValues(const Model * m)
 {
-  return getComponentValuesForModel(m, mValues);
+  return mContext.setModel(m);
 }
 
 /**
@@ -520,7 +520,7 @@ SBMLTransforms::getComponentValuesForModel(const Model * m, IdValueMap& values)
 void 
 SBMLTransforms::clearComponentValues()
 {
-  mValues.clear();
+  mContext.clear();
 }
 
 
@@ -528,11 +528,21 @@ SBMLTransforms::clearComponentValues()
 double
 SBMLTransforms::evaluateASTNode(const ASTNode *node, const Model *m)
 {
-  if (mValues.size() == 0)
+  // do not use values that were mapped from another model
+  if (mContext.getValues().size() == 0 || 
+      (m != NULL && m != mContext.getModel()))
   {
     mapComponentValues(m);
   }
-  return evaluateASTNode(node, mValues, m);
+
+  if (m == mContext.getModel())
+  {
+    return mContext.evaluate(node);
+  }
+
+  // the values are not copied
+  EvaluationContext context(mContext.getValues(), m);
+  return context.evaluate(node);
 }
 
 double 
@@ -551,10 +561,19 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const std::map<std::string
 
 double
 SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values, const Model * m)
+{
+  EvaluationContext context(values, m);
+  return evaluateASTNode(node, context);
+}
+
+double
+SBMLTransforms::evaluateASTNode(const ASTNode * node, const EvaluationContext& context)
 {
   if (node == NULL) {
     return numeric_limits<double>::quiet_NaN();
   }
+  const IdValueMap& values = context.getValues();
+  const Model* m = context.getModel();
   double result = 0;
   int i;
   const ListOfFunctionDefinitions *lfd = NULL;
@@ -596,15 +615,15 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
             const Reaction *rn = m->getReaction(node->getName()); 
             if (r != NULL)
             {
-              result = evaluateASTNode(r->getMath(), values, m);
+              result = evaluateASTNode(r->getMath(), context);
             }
             else if (ia != NULL)
             {
-              result = evaluateASTNode(ia->getMath(), values, m);
+              result = evaluateASTNode(ia->getMath(), context);
             }
             else if (rn != NULL && rn->isSetKineticLaw())
             {
-              result = evaluateASTNode(rn->getKineticLaw()->getMath(), values, m);
+              result = evaluateASTNode(rn->getKineticLaw()->getMath(), context);
             }
           }
         }
@@ -653,14 +672,12 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
     /* shouldnt get here */
     // but we do if math we are expanding uses a functionDefinition
     {
-        if(m != NULL){
-            lfd = m->getListOfFunctionDefinitions();
-        }
+        lfd = context.getListOfFunctionDefinitions();
         if (lfd != NULL && lfd->get(node->getName()) != NULL)
         {
             tempNode = node->deepCopy();
             replaceFD(tempNode, lfd);
-            result = evaluateASTNode(tempNode, values, m);
+            result = evaluateASTNode(tempNode, context);
             delete tempNode;
         }
         else
@@ -677,24 +694,24 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
     }
     else if (node->getNumChildren() == 1)
     {
-      result = evaluateASTNode(node->getChild(0), values, m);
+      result = evaluateASTNode(node->getChild(0), context);
     }
     else
     {
-      result = evaluateASTNode(node->getChild(0), values, m);
+      result = evaluateASTNode(node->getChild(0), context);
       for (unsigned int j = 1; j < node->getNumChildren(); ++j)
       {
-        result = result + evaluateASTNode(node->getChild(j), values, m) ;
+        result = result + evaluateASTNode(node->getChild(j), context) ;
       }
     }
     break;
 
   case AST_MINUS:
     if(node->getNumChildren() == 1)
-      result = -(evaluateASTNode(node->getChild(0), values, m));
+      result = -(evaluateASTNode(node->getChild(0), context));
     else
-      result = evaluateASTNode(node->getChild(0), values, m) -
-      evaluateASTNode(node->getChild(1), values, m);
+      result = evaluateASTNode(node->getChild(0), context) -
+      evaluateASTNode(node->getChild(1), context);
     break;
 
   case AST_TIMES:
@@ -704,130 +721,130 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
     }
     else if (node->getNumChildren() == 1)
     {
-      result = evaluateASTNode(node->getChild(0), values, m);
+      result = evaluateASTNode(node->getChild(0), context);
     }
     else
     {
-      result = evaluateASTNode(node->getChild(0), values, m);
+      result = evaluateASTNode(node->getChild(0), context);
       for (unsigned int j = 1; j < node->getNumChildren(); ++j)
       {
-        result = result * evaluateASTNode(node->getChild(j), values, m) ;
+        result = result * evaluateASTNode(node->getChild(j), context) ;
       }
     }
     break;
 
   case AST_DIVIDE:
-    result = evaluateASTNode(node->getChild(0), values, m) /
-      evaluateASTNode(node->getChild(1), values, m);
+    result = evaluateASTNode(node->getChild(0), context) /
+      evaluateASTNode(node->getChild(1), context);
     break;
 
   case AST_POWER:
   case AST_FUNCTION_POWER:
-    result = pow(evaluateASTNode(node->getChild(0), values, m),
-      evaluateASTNode(node->getChild(1), values, m));
+    result = pow(evaluateASTNode(node->getChild(0), context),
+      evaluateASTNode(node->getChild(1), context));
     break;
 
   case AST_FUNCTION_ABS:
-    result = (double)(fabs((double)(evaluateASTNode(node->getChild(0), values, m))));
+    result = (double)(fabs((double)(evaluateASTNode(node->getChild(0), context))));
     break;
 
   case AST_FUNCTION_ARCCOS:
-    result = acos(evaluateASTNode(node->getChild(0), values, m));
+    result = acos(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_ARCCOSH:
     /* arccosh(x) = ln(x + sqrt(x-1).sqrt(x+1)) */
-    result = log(evaluateASTNode(node->getChild(0), values, m)
-      + pow((evaluateASTNode(node->getChild(0), values, m) - 1), 0.5)
-      * pow((evaluateASTNode(node->getChild(0), values, m) + 1), 0.5));
+    result = log(evaluateASTNode(node->getChild(0), context)
+      + pow((evaluateASTNode(node->getChild(0), context) - 1), 0.5)
+      * pow((evaluateASTNode(node->getChild(0), context) + 1), 0.5));
     break;
 
   case AST_FUNCTION_ARCCOT:
     /* arccot x =  arctan (1 / x) */
-    result = atan(1.0 / evaluateASTNode(node->getChild(0), values, m));
+    result = atan(1.0 / evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_ARCCOTH:
     /* arccoth x = 1/2 * ln((x+1)/(x-1)) */
-    result = ((1.0 / 2.0) * log((evaluateASTNode(node->getChild(0), values, m) + 1.0)
-      / (evaluateASTNode(node->getChild(0), values, m) - 1.0)));
+    result = ((1.0 / 2.0) * log((evaluateASTNode(node->getChild(0), context) + 1.0)
+      / (evaluateASTNode(node->getChild(0), context) - 1.0)));
     break;
 
   case AST_FUNCTION_ARCCSC:
     /* arccsc(x) = Arcsin(1 / x) */
-    result = asin(1.0 / evaluateASTNode(node->getChild(0), values, m));
+    result = asin(1.0 / evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_ARCCSCH:
     /* arccsch(x) = ln((1 + sqrt(1 + x^2)) / x) */
     result = log((1.0 + pow(1.0 + 
-      pow(evaluateASTNode(node->getChild(0), values, m), 2), 0.5))
-      / evaluateASTNode(node->getChild(0), values, m));
+      pow(evaluateASTNode(node->getChild(0), context), 2), 0.5))
+      / evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_ARCSEC:
     /* arcsec(x) = arccos(1/x) */
-    result = acos(1.0 / evaluateASTNode(node->getChild(0), values, m));
+    result = acos(1.0 / evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_ARCSECH:
     /* arcsech(x) = ln((1 + sqrt(1 - x^2)) / x) */
     result = log((1.0 + pow((1.0 - 
-      pow(evaluateASTNode(node->getChild(0), values, m), 2)), 0.5))
-      / evaluateASTNode(node->getChild(0), values, m));
+      pow(evaluateASTNode(node->getChild(0), context), 2)), 0.5))
+      / evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_ARCSIN:
-    result = asin(evaluateASTNode(node->getChild(0), values, m));
+    result = asin(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_ARCSINH:
     /* arcsinh(x) = ln(x + sqrt(1 + x^2)) */
-    result = log(evaluateASTNode(node->getChild(0), values, m)
-      + pow((1.0 + pow(evaluateASTNode(node->getChild(0), values, m), 2)), 0.5));
+    result = log(evaluateASTNode(node->getChild(0), context)
+      + pow((1.0 + pow(evaluateASTNode(node->getChild(0), context), 2)), 0.5));
     break;
 
   case AST_FUNCTION_ARCTAN:
-    result = atan(evaluateASTNode(node->getChild(0), values, m));
+    result = atan(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_ARCTANH:
     /* arctanh = 0.5 * ln((1+x)/(1-x)) */
-    result = 0.5 * log((1.0 + evaluateASTNode(node->getChild(0), values, m))
-      / (1.0 - evaluateASTNode(node->getChild(0), values, m)));
+    result = 0.5 * log((1.0 + evaluateASTNode(node->getChild(0), context))
+      / (1.0 - evaluateASTNode(node->getChild(0), context)));
     break;
 
   case AST_FUNCTION_CEILING:
-    result = ceil(evaluateASTNode(node->getChild(0), values, m));
+    result = ceil(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_COS:
-    result = cos(evaluateASTNode(node->getChild(0), values, m));
+    result = cos(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_COSH:
-    result = cosh(evaluateASTNode(node->getChild(0), values, m));
+    result = cosh(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_COT:
     /* cot x = 1 / tan x */
-    result = (1.0 / tan(evaluateASTNode(node->getChild(0), values, m)));
+    result = (1.0 / tan(evaluateASTNode(node->getChild(0), context)));
     break;
 
   case AST_FUNCTION_COTH:
     /* coth x = cosh x / sinh x */
-    result = cosh(evaluateASTNode(node->getChild(0), values, m)) /
-      sinh(evaluateASTNode(node->getChild(0), values, m));
+    result = cosh(evaluateASTNode(node->getChild(0), context)) /
+      sinh(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_CSC:
     /* csc x = 1 / sin x */
-    result = (1.0 / sin(evaluateASTNode(node->getChild(0), values, m)));
+    result = (1.0 / sin(evaluateASTNode(node->getChild(0), context)));
     break;
 
   case AST_FUNCTION_CSCH:
     /* csch x = 1 / sinh x  */
-    result = (1.0 / sinh(evaluateASTNode(node->getChild(0), values, m)));
+    result = (1.0 / sinh(evaluateASTNode(node->getChild(0), context)));
     break;
 
   case AST_FUNCTION_DELAY:
@@ -835,11 +852,11 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
     break;
 
   case AST_FUNCTION_EXP:
-    result = exp(evaluateASTNode(node->getChild(0), values, m));
+    result = exp(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_FACTORIAL:
-    i = (int)(floor(evaluateASTNode(node->getChild(0), values, m)));
+    i = (int)(floor(evaluateASTNode(node->getChild(0), context)));
     for(result=1; i>1; --i)
     {
       result *= i;
@@ -847,15 +864,15 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
     break;
 
   case AST_FUNCTION_FLOOR:
-    result = floor(evaluateASTNode(node->getChild(0), values, m));
+    result = floor(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_LN:
-    result = log(evaluateASTNode(node->getChild(0), values, m));
+    result = log(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_LOG:
-    result = log10(evaluateASTNode(node->getChild(1), values, m));
+    result = log10(evaluateASTNode(node->getChild(1), context));
     break;
 
   case AST_FUNCTION_PIECEWISE:    
@@ -867,8 +884,8 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
         for (unsigned int j = 0; j < numChildren; j+=2)
         {
           // compute piece
-          double value = evaluateASTNode(node->getChild(j), values, m);
-          double boolean = evaluateASTNode(node->getChild(j + 1), values, m);
+          double value = evaluateASTNode(node->getChild(j), context);
+          double boolean = evaluateASTNode(node->getChild(j + 1), context);
           if (boolean == 1.0)
           {
             // we might have two true piece statements
@@ -903,8 +920,8 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
         for (unsigned int j = 0; j < numChildren-1; j+=2)
         {
           // compute piece
-          double value = evaluateASTNode(node->getChild(j), values, m);
-          double boolean = evaluateASTNode(node->getChild(j + 1), values, m);
+          double value = evaluateASTNode(node->getChild(j), context);
+          double boolean = evaluateASTNode(node->getChild(j + 1), context);
           if (boolean == 1.0)
           {
             // we might have two true piece statements
@@ -931,41 +948,41 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
         if (!assigned)
         {
           // compute otherwise
-          result = evaluateASTNode(node->getChild(numChildren - 1), values, m);
+          result = evaluateASTNode(node->getChild(numChildren - 1), context);
         }
       }
     }
     break;
 
   case AST_FUNCTION_ROOT:
-    result = pow(evaluateASTNode(node->getChild(1), values, m),
-      (1.0 / evaluateASTNode(node->getChild(0), values, m)));
+    result = pow(evaluateASTNode(node->getChild(1), context),
+      (1.0 / evaluateASTNode(node->getChild(0), context)));
     break;
 
   case AST_FUNCTION_SEC:
     /* sec x = 1 / cos x */
-    result = 1.0 / cos(evaluateASTNode(node->getChild(0), values, m));
+    result = 1.0 / cos(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_SECH:
     /* sech x = 1 / cosh x */
-    result = 1.0 / cosh(evaluateASTNode(node->getChild(0), values, m));
+    result = 1.0 / cosh(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_SIN:
-    result = sin(evaluateASTNode(node->getChild(0), values, m));
+    result = sin(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_SINH:
-    result = sinh(evaluateASTNode(node->getChild(0), values, m));
+    result = sinh(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_TAN:
-    result = tan(evaluateASTNode(node->getChild(0), values, m));
+    result = tan(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_FUNCTION_TANH:
-    result = tanh(evaluateASTNode(node->getChild(0), values, m));
+    result = tanh(evaluateASTNode(node->getChild(0), context));
     break;
 
   case AST_LOGICAL_AND:
@@ -973,15 +990,15 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
       if (node->getNumChildren() == 0)
         result = 1.0;
       else if (node->getNumChildren() == 1)
-        result = evaluateASTNode(node->getChild(0), values, m);
+        result = evaluateASTNode(node->getChild(0), context);
       else
-        result = (double)((evaluateASTNode(node->getChild(0), values, m))
-        && (evaluateASTNode(node->getChild(1), values, m)));
+        result = (double)((evaluateASTNode(node->getChild(0), context))
+        && (evaluateASTNode(node->getChild(1), context)));
     }
     break;
 
   case AST_LOGICAL_NOT:
-    result = (double)(!(evaluateASTNode(node->getChild(0), values, m)));
+    result = (double)(!(evaluateASTNode(node->getChild(0), context)));
     break;
 
   case AST_LOGICAL_OR:
@@ -989,10 +1006,10 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
       if (node->getNumChildren() == 0)
         result = 0.0;
       else if (node->getNumChildren() == 1)
-        result = evaluateASTNode(node->getChild(0), values, m);
+        result = evaluateASTNode(node->getChild(0), context);
       else
-        result = (double)((evaluateASTNode(node->getChild(0), values, m))
-        || (evaluateASTNode(node->getChild(1), values, m)));
+        result = (double)((evaluateASTNode(node->getChild(0), context))
+        || (evaluateASTNode(node->getChild(1), context)));
     }
     break;
 
@@ -1001,12 +1018,12 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
       if (node->getNumChildren() == 0)
         result = 0.0;
       else if (node->getNumChildren() == 1)
-        result = evaluateASTNode(node->getChild(0), values, m);
+        result = evaluateASTNode(node->getChild(0), context);
       else
-        result = (double)((!(evaluateASTNode(node->getChild(0), values, m))
-        && (evaluateASTNode(node->getChild(1), values, m)))
-        || ((evaluateASTNode(node->getChild(0), values, m))
-        && !(evaluateASTNode(node->getChild(1), values, m))));
+        result = (double)((!(evaluateASTNode(node->getChild(0), context))
+        && (evaluateASTNode(node->getChild(1), context)))
+        || ((evaluateASTNode(node->getChild(0), context))
+        && !(evaluateASTNode(node->getChild(1), context))));
     }
     break;
 
@@ -1016,8 +1033,8 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
     {      
       result = 1.0;
       for (unsigned int j = 1; j < node->getNumChildren(); ++j)
-        result *= (double)((evaluateASTNode(node->getChild(j-1), values, m))
-        == (evaluateASTNode(node->getChild(j), values, m)));
+        result *= (double)((evaluateASTNode(node->getChild(j-1), context))
+        == (evaluateASTNode(node->getChild(j), context)));
     }
     break;
 
@@ -1027,8 +1044,8 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
     {      
       result = 1.0;
       for (unsigned int j = 1; j < node->getNumChildren(); ++j)
-        result *= (double)((evaluateASTNode(node->getChild(j-1), values, m))
-        >= (evaluateASTNode(node->getChild(j), values, m)));
+        result *= (double)((evaluateASTNode(node->getChild(j-1), context))
+        >= (evaluateASTNode(node->getChild(j), context)));
     }
     break;
 
@@ -1038,8 +1055,8 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
     {      
       result = 1.0;
       for (unsigned int j = 1; j < node->getNumChildren(); ++j)
-        result *= (double)((evaluateASTNode(node->getChild(j-1), values, m))
-        > (evaluateASTNode(node->getChild(j), values, m)));
+        result *= (double)((evaluateASTNode(node->getChild(j-1), context))
+        > (evaluateASTNode(node->getChild(j), context)));
     }
     break;
 
@@ -1049,8 +1066,8 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
     {      
       result = 1.0;
       for (unsigned int j = 1; j < node->getNumChildren(); ++j)
-         result *= (double)((evaluateASTNode(node->getChild(j-1), values, m))
-         <= (evaluateASTNode(node->getChild(j), values, m)));
+         result *= (double)((evaluateASTNode(node->getChild(j-1), context))
+         <= (evaluateASTNode(node->getChild(j), context)));
     }
     break;
 
@@ -1060,8 +1077,8 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
     {      
       result = 1.0;
       for (unsigned int j = 1; j < node->getNumChildren(); ++j)
-        result *= (double)((evaluateASTNode(node->getChild(j-1), values, m))
-        < (evaluateASTNode(node->getChild(j), values, m)));
+        result *= (double)((evaluateASTNode(node->getChild(j-1), context))
+        < (evaluateASTNode(node->getChild(j), context)));
     }
     break;
 
@@ -1071,22 +1088,28 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
     {      
       result = 1.0;
       for (unsigned int j = 1; j < node->getNumChildren(); ++j)
-        result *= (double)((evaluateASTNode(node->getChild(j-1), values, m))
-        != (evaluateASTNode(node->getChild(j), values, m)));
+        result *= (double)((evaluateASTNode(node->getChild(j-1), context))
+        != (evaluateASTNode(node->getChild(j), context)));
     }
     break;
 
   default:
     if (node->getNumPlugins() == 0)
     {
-      ((ASTNode*)(node))->loadASTPlugins(NULL);
+      // use the registered plugin rather than loading plugins into the node,
+      // which must not be modified here
+      const ASTBasePlugin* baseplugin = node->getASTPlugin(node->getType());
+      if (baseplugin != NULL)
+      {
+        result = baseplugin->evaluateASTNode(node, context);
+      }
     }
     for (unsigned int p = 0; p < node->getNumPlugins(); p++)
     {
       const ASTBasePlugin* baseplugin = node->getPlugin(p);
       if (baseplugin->defines(node->getType()))
       {
-        result = baseplugin->evaluateASTNode(node, m);
+        result = baseplugin->evaluateASTNode(node, context);
       }
     }
   }
@@ -1096,14 +1119,15 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
 }
 
 bool
-SBMLTransforms::expandIA(Model* m, const InitialAssignment* ia)
+SBMLTransforms::expandIA(Model* m, const InitialAssignment* ia,
+                         EvaluationContext& context)
 {
   bool removed = false;
   std::string id = ia->getSymbol();
   if (m->getCompartment(id) != NULL) 
   {
     if (expandInitialAssignment(m->getCompartment(id), 
-                                ia))
+                                ia, context))
     {
       delete m->removeInitialAssignment(id);
       removed = true;
@@ -1112,7 +1136,7 @@ SBMLTransforms::expandIA(Model* m, const InitialAssignment* ia)
   else if (m->getParameter(id) != NULL)
   {
     if (expandInitialAssignment(m->getParameter(id), 
-                                ia))
+                                ia, context))
     {
       delete m->removeInitialAssignment(id);
       removed = true;
@@ -1121,7 +1145,7 @@ SBMLTransforms::expandIA(Model* m, const InitialAssignment* ia)
   else if (m->getSpecies(id) != NULL)
   {
     if (expandInitialAssignment(m->getSpecies(id), 
-                                ia))
+                                ia, context))
     {
       delete m->removeInitialAssignment(id);
       removed = true;
@@ -1138,7 +1162,7 @@ SBMLTransforms::expandIA(Model* m, const InitialAssignment* ia)
         if (r->getProduct(k)->getId() == id)
         {
           if (expandInitialAssignment(r->getProduct(k), 
-                                      ia))
+                                      ia, context))
           {
             delete m->removeInitialAssignment(id);
             removed = true;
@@ -1150,7 +1174,7 @@ SBMLTransforms::expandIA(Model* m, const InitialAssignment* ia)
         if (r->getReactant(k)->getId() == id)
         {
           if (expandInitialAssignment(r->getReactant(k), 
-                                      ia))
+                                      ia, context))
           {
             delete m->removeInitialAssignment(id);
             removed = true;
@@ -1166,10 +1190,11 @@ SBMLTransforms::expandIA(Model* m, const InitialAssignment* ia)
 bool 
 SBMLTransforms::expandInitialAssignments(Model * m)
 {
-  IdList idsNoValues = mapComponentValues(m);
+  EvaluationContext context;
+  IdList idsNoValues = context.setModel(m);
   IdList idsWithValues;
 
-  IdValueIter iter;
+  IdValueMap::const_iterator iter;
   bool needToBail = false;
   unsigned int count;
 
@@ -1181,7 +1206,8 @@ SBMLTransforms::expandInitialAssignments(Model * m)
     
     /* list ids that have a calculated/assigned value */
     idsWithValues.clear();
-    for (iter = mValues.begin(); iter != mValues.end(); ++iter)
+    for (iter = context.getValues().begin(); 
+         iter != context.getValues().end(); ++iter)
     {
       if (((*iter).second).second)
       {
@@ -1198,7 +1224,7 @@ SBMLTransforms::expandInitialAssignments(Model * m)
           if (!nodeContainsNameNotInList(m->getInitialAssignment(i)->getMath(), 
                                                                    idsWithValues))
           {
-            bool removed = expandIA(m, m->getInitialAssignment(i));
+            bool removed = expandIA(m, m->getInitialAssignment(i), context);
             if (removed) count--;
           }
         }
@@ -1220,9 +1246,6 @@ SBMLTransforms::expandInitialAssignments(Model * m)
   }
   while(count > 0 && needToBail == false);
 
-  // clear the internal map of values
-  mValues.clear();
-
   return true;
 }
 
@@ -1230,10 +1253,11 @@ SBMLTransforms::expandInitialAssignments(Model * m)
 bool 
 SBMLTransforms::expandL3V2InitialAssignments(Model * m)
 {
-  IdList idsNoValues = mapComponentValues(m);
+  EvaluationContext context;
+  IdList idsNoValues = context.setModel(m);
   IdList idsWithValues;
 
-  IdValueIter iter;
+  IdValueMap::const_iterator iter;
   bool needToBail = false;
   unsigned int count;
 
@@ -1245,7 +1269,8 @@ SBMLTransforms::expandL3V2InitialAssignments(Model * m)
     
     /* list ids that have a calculated/assigned value */
     idsWithValues.clear();
-    for (iter = mValues.begin(); iter != mValues.end(); ++iter)
+    for (iter = context.getValues().begin(); 
+         iter != context.getValues().end(); ++iter)
     {
       if (((*iter).second).second)
       {
@@ -1263,7 +1288,7 @@ SBMLTransforms::expandL3V2InitialAssignments(Model * m)
         {
           if (!nodeContainsNameNotInList(ia->getMath(), idsWithValues))
           {
-            bool removed = expandIA(m, ia);
+            bool removed = expandIA(m, ia, context);
             if (removed) count--;
           }
         }
@@ -1285,25 +1310,20 @@ SBMLTransforms::expandL3V2InitialAssignments(Model * m)
   }
   while(count > 0 && needToBail == false);
 
-  // clear the internal map of values
-  mValues.clear();
-
   return true;
 }
 
 
 bool 
 SBMLTransforms::expandInitialAssignment(Compartment * c, 
-    const InitialAssignment *ia)
+    const InitialAssignment *ia, EvaluationContext& context)
 {
   bool success = false; 
-  double value = evaluateASTNode(ia->getMath(), c->getModel());
+  double value = context.evaluate(ia->getMath());
   if (!util_isNaN(value))
   {
     c->setSize(value);
-    IdValueIter it = mValues.find(c->getId());
-    ((*it).second).first = value;
-    ((*it).second).second = true;
+    context.setValue(c->getId(), value);
     success = true;
   }
 
@@ -1312,16 +1332,14 @@ SBMLTransforms::expandInitialAssignment(Compartment * c,
 
 bool 
 SBMLTransforms::expandInitialAssignment(Parameter * p, 
-    const InitialAssignment *ia)
+    const InitialAssignment *ia, EvaluationContext& context)
 {
   bool success = false; 
-  double value = evaluateASTNode(ia->getMath(), p->getModel());
+  double value = context.evaluate(ia->getMath());
   if (!util_isNaN(value))
   {
     p->setValue(value);
-    IdValueIter it = mValues.find(p->getId());
-    ((*it).second).first = value;
-    ((*it).second).second = true;
+    context.setValue(p->getId(), value);
     success = true;
   }
 
@@ -1330,16 +1348,14 @@ SBMLTransforms::expandInitialAssignment(Parameter * p,
 
 bool 
 SBMLTransforms::expandInitialAssignment(SpeciesReference * sr, 
-    const InitialAssignment *ia)
+    const InitialAssignment *ia, EvaluationContext& context)
 {
   bool success = false; 
-  double value = evaluateASTNode(ia->getMath(), sr->getModel());
+  double value = context.evaluate(ia->getMath());
   if (!util_isNaN(value))
   {
     sr->setStoichiometry(value);
-    IdValueIter it = mValues.find(sr->getId());
-    ((*it).second).first = value;
-    ((*it).second).second = true;
+    context.setValue(sr->getId(), value);
     success = true;
   }
 
@@ -1348,10 +1364,10 @@ SBMLTransforms::expandInitialAssignment(SpeciesReference * sr,
 
 bool 
 SBMLTransforms::expandInitialAssignment(Species * s, 
-    const InitialAssignment *ia)
+    const InitialAssignment *ia, EvaluationContext& context)
 {
   bool success = false; 
-  double value = evaluateASTNode(ia->getMath(), s->getModel());
+  double value = context.evaluate(ia->getMath());
   if (!util_isNaN(value))
   {
     if (s->getHasOnlySubstanceUnits())
@@ -1363,14 +1379,149 @@ SBMLTransforms::expandInitialAssignment(Species * s,
       s->setInitialConcentration(value);
     }
 
-    IdValueIter it = mValues.find(s->getId());
-    ((*it).second).first = value;
-    ((*it).second).second = true;
+    context.setValue(s->getId(), value);
     success = true;
   }
 
   return success;
 }
+
+
+EvaluationContext::EvaluationContext(const Model * m) :
+    mModel (NULL)
+  , mFunctionDefinitions (NULL)
+  , mValues ()
+  , mValueRef (&mValues)
+{
+  if (m != NULL)
+  {
+    setModel(m);
+  }
+}
+
+
+EvaluationContext::EvaluationContext(const IdValueMap& values, 
+                                     const Model * m) :
+    mModel (m)
+  , mFunctionDefinitions (NULL)
+  , mValues ()
+  , mValueRef (&values)
+{
+}
+
+
+EvaluationContext::EvaluationContext(const EvaluationContext& orig) :
+    mModel (orig.mModel)
+  , mFunctionDefinitions (orig.mFunctionDefinitions)
+  , mValues (orig.mValues)
+  , mValueRef (orig.mValueRef == &orig.mValues ? &mValues : orig.mValueRef)
+{
+}
+
+
+EvaluationContext&
+EvaluationContext::operator=(const EvaluationContext& rhs)
+{
+  if (&rhs != this)
+  {
+    mModel = rhs.mModel;
+    mFunctionDefinitions = rhs.mFunctionDefinitions;
+    mValues = rhs.mValues;
+    mValueRef = (rhs.mValueRef == &rhs.mValues) ? &mValues : rhs.mValueRef;
+  }
+  return *this;
+}
+
+
+IdList
+EvaluationContext::setModel(const Model * m)
+{
+  mModel = m;
+  mValueRef = &mValues;
+
+  return SBMLTransforms::getComponentValuesForModel(m, mValues);
+}
+
+
+const Model *
+EvaluationContext::getModel() const
+{
+  return mModel;
+}
+
+
+void
+EvaluationContext::setListOfFunctionDefinitions(
+                                 const ListOfFunctionDefinitions * lofd)
+{
+  mFunctionDefinitions = lofd;
+}
+
+
+const ListOfFunctionDefinitions *
+EvaluationContext::getListOfFunctionDefinitions() const
+{
+  if (mFunctionDefinitions != NULL || mModel == NULL)
+  {
+    return mFunctionDefinitions;
+  }
+  return mModel->getListOfFunctionDefinitions();
+}
+
+
+const EvaluationContext::IdValueMap&
+EvaluationContext::getValues() const
+{
+  return *mValueRef;
+}
+
+
+void
+EvaluationContext::setValue(const std::string& id, double value)
+{
+  copyOnWrite();
+
+  IdValueMap::iterator it = mValues.find(id);
+  if (it == mValues.end())
+  {
+    mValues.insert(IdValueMap::value_type(id, 
+                                          SBMLTransforms::ValueSet(value, true)));
+  }
+  else
+  {
+    ((*it).second).first = value;
+    ((*it).second).second = true;
+  }
+}
+
+
+void
+EvaluationContext::clear()
+{
+  mModel = NULL;
+  mFunctionDefinitions = NULL;
+  mValues.clear();
+  mValueRef = &mValues;
+}
+
+
+double
+EvaluationContext::evaluate(const ASTNode * node) const
+{
+  return SBMLTransforms::evaluateASTNode(node, *this);
+}
+
+
+void
+EvaluationContext::copyOnWrite()
+{
+  if (mValueRef != &mValues)
+  {
+    mValues = *mValueRef;
+    mValueRef = &mValues;
+  }
+}
+
 /** @endcond */
 
 #endif /* __cplusplus */
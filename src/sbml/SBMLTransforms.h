@@ -64,6 +64,7 @@
 LIBSBML_CPP_NAMESPACE_BEGIN
 
 class IdList;
+class EvaluationContext;
 
 #ifdef LIBSBML_USE_STRICT_INCLUDES
 class ASTNode;
@@ -142,6 +143,7 @@ public:
 #ifndef SWIG
   static double evaluateASTNode(const ASTNode * node, const IdValueMap& values, const Model * m = NULL);
   static double evaluateASTNode(const ASTNode * node, const std::map<std::string, double>& values, const Model * m = NULL);
+  static double evaluateASTNode(const ASTNode * node, const EvaluationContext& context);
   static IdList getComponentValuesForModel(const Model * m, IdValueMap& values);
 #endif
   
@@ -161,27 +163,130 @@ protected:
   static bool nodeContainsNameNotInList(const ASTNode * node, IdList& ids);
   
   static bool expandInitialAssignment(Parameter * p, 
-                                          const InitialAssignment *ia);
+                                          const InitialAssignment *ia,
+                                          EvaluationContext& context);
   
   static bool expandInitialAssignment(Compartment * c, 
-                                          const InitialAssignment *ia);
+                                          const InitialAssignment *ia,
+                                          EvaluationContext& context);
   
   static bool expandInitialAssignment(SpeciesReference * sr, 
-                                          const InitialAssignment *ia);
+                                          const InitialAssignment *ia,
+                                          EvaluationContext& context);
   
   static bool expandInitialAssignment(Species * s, 
-                                          const InitialAssignment *ia);
+                                          const InitialAssignment *ia,
+                                          EvaluationContext& context);
 
-  static bool expandIA(Model* m, const InitialAssignment *ia);
+  static bool expandIA(Model* m, const InitialAssignment *ia,
+                       EvaluationContext& context);
 
   static void recurseReplaceFD(ASTNode * math, const FunctionDefinition * fd,
                         const IdList* idsToExclude);
 
 
-  static IdValueMap mValues;
+  static EvaluationContext mContext;
 
 };
 
+
+#ifndef SWIG
+
+/**
+ * An EvaluationContext holds everything needed to evaluate math
+ * numerically: the values of the model components, the model whose rules,
+ * initial assignments and kinetic laws define the components that do not
+ * have a value, and the function definitions used by the math.
+ *
+ * The static SBMLTransforms::evaluateASTNode() functions share a single
+ * process-wide context.  Separate EvaluationContext objects are
+ * independent of each other, so that different threads may evaluate
+ * math, each with its own context, provided that the models involved are
+ * not modified at the same time.
+ */
+class LIBSBML_EXTERN EvaluationContext
+{
+public:
+
+  typedef SBMLTransforms::IdValueMap IdValueMap;
+
+  /**
+   * Creates a context holding the values of the components of the given
+   * model (see setModel()).
+   */
+  EvaluationContext(const Model * m = NULL);
+
+
+  /**
+   * Creates a context that uses the given values, which are not copied
+   * and must outlive the context until setValue() or setModel() is called.
+   * The model is only used to look up rules, initial assignments, kinetic
+   * laws and function definitions.
+   */
+  EvaluationContext(const IdValueMap& values, const Model * m = NULL);
+
+
+  EvaluationContext(const EvaluationContext& orig);
+
+
+  EvaluationContext& operator=(const EvaluationContext& rhs);
+
+
+  /**
+   * Replaces the values of this context by those of the components of the
+   * given model.
+   *
+   * @return the ids of the components whose value cannot be determined.
+   */
+  IdList setModel(const Model * m);
+
+
+  const Model * getModel() const;
+
+
+  /**
+   * Sets the function definitions used to expand function calls; by
+   * default they are those of the model.
+   */
+  void setListOfFunctionDefinitions(const ListOfFunctionDefinitions * lofd);
+
+
+  const ListOfFunctionDefinitions * getListOfFunctionDefinitions() const;
+
+
+  const IdValueMap& getValues() const;
+
+
+  /**
+   * Records the (calculated) value of the component with the given id.
+   */
+  void setValue(const std::string& id, double value);
+
+
+  /**
+   * Removes all values and the model from this context.
+   */
+  void clear();
+
+
+  /**
+   * @return the value of the math, or NaN if it cannot be evaluated.
+   */
+  double evaluate(const ASTNode * node) const;
+
+
+private:
+
+  void copyOnWrite();
+
+  const Model * mModel;
+  const ListOfFunctionDefinitions * mFunctionDefinitions;
+  IdValueMap mValues;
+  const IdValueMap * mValueRef;
+};
+
+#endif
+
 LIBSBML_CPP_NAMESPACE_END
 
 #endif  /* __cplusplus */
@@ -493,6 +493,9 @@ SBase::~SBase ()
   if (mHistory != NULL) delete mHistory;
   mHasBeenDeleted = true;
 
+  // the model may have indexed this object
+  if (mParentSBMLObject != NULL) invalidateModelIdIndex();
+
   for_each( mPlugins.begin(), mPlugins.end(), DeletePluginEntity() );
   deleteDisabledPlugins(false);
 }
@@ -504,6 +507,7 @@ SBase& SBase::operator=(const SBase& rhs)
 {
   if(&rhs!=this)
   {
+    updateParentIdIndex(rhs.mId);
     this->mId     = rhs.mId;
     this->mName   = rhs.mName;
     this->mMetaId = rhs.mMetaId;
@@ -1268,6 +1272,7 @@ SBase::setId (const std::string& sid)
     }
     else
     {
+      updateParentIdIndex(sid);
       mId = sid;
       return LIBSBML_OPERATION_SUCCESS;
     }
@@ -1303,6 +1308,7 @@ SBase::setIdAttribute (const std::string& sid)
   }
   else
   {
+    updateParentIdIndex(sid);
     mId = sid;
     return LIBSBML_OPERATION_SUCCESS;
   }
@@ -2350,6 +2356,15 @@ SBase::setModelHistory(ModelHistory * history)
 void
 SBase::setSBMLDocument (SBMLDocument* d)
 {
+  // an object leaving its document keeps the namespaces it was using,
+  // since the document may well be deleted before the object is
+  if (d == NULL && mSBML != NULL && mSBML != this
+    && mSBML->mSBMLNamespaces != NULL)
+  {
+    delete mSBMLNamespaces;
+    mSBMLNamespaces = mSBML->mSBMLNamespaces->clone();
+  }
+
   mSBML = d;
 
   //
@@ -2553,6 +2568,7 @@ SBase::unsetId ()
 {
   if (getLevel() == 3 && getVersion() > 1)
   {
+    updateParentIdIndex("");
     mId.erase();
     // HACK to make a rule in l3v2 not able to use this function
     int tc = getTypeCode();
@@ -2583,6 +2599,7 @@ SBase::unsetId ()
 int
 SBase::unsetIdAttribute ()
 {
+  updateParentIdIndex("");
   mId.erase();
 
   if (mId.empty())
@@ -4464,7 +4481,9 @@ SBase::read (XMLInputStream& stream)
 
   ExpectedAttributes expectedAttributes;
   addExpectedAttributes(expectedAttributes);
+  const std::string oldid = mId;
   readAttributes( element.getAttributes(), expectedAttributes );
+  updateParentIdIndex(oldid, mId);
 
   /* if we are reading a document pass the
    * SBML Namespace information to the input stream object
@@ -4546,9 +4565,12 @@ SBase::read (XMLInputStream& stream)
 
   if ( element.isEnd() ) return;
 
+  SBMLDocument* doc = getSBMLDocument();
+
   while ( stream.isGood() )
   {
-    if (CallbackRegistry::invokeCallbacks(getSBMLDocument()) != LIBSBML_OPERATION_SUCCESS)
+    if (CallbackRegistry::invokeCallbacks(doc) != LIBSBML_OPERATION_SUCCESS
+      || (doc != NULL && doc->mComponentHandlerStopped))
     {
       if (getErrorLog() != NULL && !getErrorLog()->contains(OperationInterrupted))
         logError(OperationInterrupted, getLevel(), getVersion());
@@ -4615,7 +4637,16 @@ SBase::read (XMLInputStream& stream)
         {
           static_cast <SpeciesReference *> (object)->sortMath();
         }
-        checkListOfPopulated(object);
+
+        if (doc != NULL && doc->handOverComponent(object))
+        {
+          continue;
+        }
+
+        if (doc == NULL || !doc->hasHandedOverComponents(object))
+        {
+          checkListOfPopulated(object);
+        }
       }
       else if ( !( storeUnknownExtElement(stream)
                    || readOtherXML(stream)
@@ -7102,6 +7133,45 @@ SBase::checkXHTML(const XMLNode * xhtml)
   }
 }
 /** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+void
+SBase::updateParentIdIndex(const std::string& sid)
+{
+  updateParentIdIndex(mId, sid);
+}
+
+
+void
+SBase::updateParentIdIndex(const std::string& oldid, const std::string& newid)
+{
+  if (mParentSBMLObject == NULL || oldid == newid) return;
+
+  if (mParentSBMLObject->getTypeCode() == SBML_LIST_OF)
+  {
+    static_cast<ListOf*>(mParentSBMLObject)->updateIdIndex(this, oldid, newid);
+  }
+  invalidateModelIdIndex();
+}
+
+
+void
+SBase::invalidateModelIdIndex()
+{
+  // the document is its own parent
+  for (SBase* p = mParentSBMLObject; p != NULL && p != p->mParentSBMLObject;
+       p = p->mParentSBMLObject)
+  {
+    Model* m = dynamic_cast<Model*>(p);
+    if (m != NULL)
+    {
+      m->invalidateElementIdIndex();
+      return;
+    }
+  }
+}
+/** @endcond */
 /** @cond doxygenLibsbmlInternal */
 /* default for components that have no required attributes */
 bool
@@ -3522,7 +3522,31 @@ protected:
    */
   void checkXHTML(const XMLNode *);
 
-  
+
+  /**
+   * Informs the parent ListOf (if any) that the identifier of this object
+   * is about to change to @p sid, so that the identifier index of the
+   * ListOf stays in sync.  Must be called before @c mId is modified.
+   */
+  void updateParentIdIndex(const std::string& sid);
+
+
+  /**
+   * Informs the parent ListOf (if any) that the identifier of this object
+   * changed from @p oldid to @p newid, and the enclosing Model that its
+   * element index is out of date.
+   */
+  void updateParentIdIndex(const std::string& oldid, const std::string& newid);
+
+
+  /**
+   * Informs the enclosing Model (if any) that elements were added to,
+   * removed from or renamed within it, so that the index used by
+   * Model::getElementBySId() has to be rebuilt.
+   */
+  void invalidateModelIdIndex();
+
+
   // ------------------------------------------------------------------
   //
   // protected functions for EXTENSION
@@ -243,6 +243,7 @@ SimpleSpeciesReference::setId (const std::string& sid)
                    
     if (enabledLayoutL2)
     {
+      updateParentIdIndex(sid);
       mId = sid;
       return LIBSBML_OPERATION_SUCCESS;
     }
@@ -257,6 +258,7 @@ SimpleSpeciesReference::setId (const std::string& sid)
   }
   else
   {
+    updateParentIdIndex(sid);
     mId = sid;
     return LIBSBML_OPERATION_SUCCESS;
   }
@@ -292,6 +294,7 @@ SimpleSpeciesReference::setName (const std::string& name)
 int
 SimpleSpeciesReference::unsetId ()
 {
+  updateParentIdIndex("");
   mId.erase();
 
   if (mId.empty())
@@ -313,6 +316,7 @@ SimpleSpeciesReference::unsetName ()
 {
   if (getLevel() == 1) 
   {
+    updateParentIdIndex("");
     mId.erase();
   }
   else 
@@ -600,6 +600,7 @@ Species::setId (const std::string& sid)
   }
   else
   {
+    updateParentIdIndex(sid);
     mId = sid;
     return LIBSBML_OPERATION_SUCCESS;
   }
@@ -623,6 +624,7 @@ Species::setName (const std::string& name)
     }
     else
     {
+      updateParentIdIndex(name);
       mId = name;
       return LIBSBML_OPERATION_SUCCESS;
     }
@@ -868,6 +870,7 @@ Species::unsetName ()
 {
   if (getLevel() == 1) 
   {
+    updateParentIdIndex("");
     mId.erase();
   }
   else 
@@ -2556,17 +2559,6 @@ ListOfSpecies::get(unsigned int n) const
 }
 
 
-/**
- * Used by ListOf::get() to lookup an SBase based by its id.
- */
-struct IdEqS : public unary_function<SBase*, bool>
-{
-  const string& mId;
-
-  IdEqS (const string& id) : mId(id) { }
-  bool operator() (SBase* sb) 
-       { return static_cast <Species *> (sb)->getId() == mId; }
-};
 /* return item by id */
 Species*
 ListOfSpecies::get (const std::string& sid)
@@ -2580,10 +2572,7 @@ ListOfSpecies::get (const std::string& sid)
 const Species*
 ListOfSpecies::get (const std::string& sid) const
 {
-  vector<SBase*>::const_iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqS(sid) );
-  return (result == mItems.end()) ? NULL : static_cast <Species*> (*result);
+  return static_cast <const Species*> (getItemBySId(sid));
 }
 
 
@@ -2599,18 +2588,7 @@ ListOfSpecies::remove (unsigned int n)
 Species*
 ListOfSpecies::remove (const std::string& sid)
 {
-  SBase* item = NULL;
-  vector<SBase*>::iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqS(sid) );
-
-  if (result != mItems.end())
-  {
-    item = *result;
-    mItems.erase(result);
-  }
-
-  return static_cast <Species*> (item);
+  return static_cast <Species*> (removeItemBySId(sid));
 }
 
 
@@ -187,6 +187,7 @@ SpeciesType::setId (const std::string& sid)
   }
   else
   {
+    updateParentIdIndex(sid);
     mId = sid;
     return LIBSBML_OPERATION_SUCCESS;
   }
@@ -210,6 +211,7 @@ SpeciesType::setName (const std::string& name)
     }
     else
     {
+      updateParentIdIndex(name);
       mId = name;
       return LIBSBML_OPERATION_SUCCESS;
     }
@@ -230,6 +232,7 @@ SpeciesType::unsetName ()
 {
   if (getLevel() == 1) 
   {
+    updateParentIdIndex("");
     mId.erase();
   }
   else 
@@ -751,19 +754,6 @@ ListOfSpeciesTypes::get(unsigned int n) const
 }
 
 
-/**
- * Used by ListOf::get() to lookup an SBase based by its id.
- */
-struct IdEqST : public unary_function<SBase*, bool>
-{
-  const string& mId;
-
-  IdEqST (const string& id) : mId(id) { }
-  bool operator() (SBase* sb) 
-       { return static_cast <SpeciesType *> (sb)->getId() == mId; }
-};
-
-
 /* return item by id */
 SpeciesType*
 ListOfSpeciesTypes::get (const std::string& sid)
@@ -777,11 +767,7 @@ ListOfSpeciesTypes::get (const std::string& sid)
 const SpeciesType*
 ListOfSpeciesTypes::get (const std::string& sid) const
 {
-  vector<SBase*>::const_iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqST(sid) );
-  return (result == mItems.end()) ? NULL : 
-                             static_cast <SpeciesType*> (*result);
+  return static_cast <const SpeciesType*> (getItemBySId(sid));
 }
 
 
@@ -797,18 +783,7 @@ ListOfSpeciesTypes::remove (unsigned int n)
 SpeciesType*
 ListOfSpeciesTypes::remove (const std::string& sid)
 {
-  SBase* item = NULL;
-  vector<SBase*>::iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqST(sid) );
-
-  if (result != mItems.end())
-  {
-    item = *result;
-    mItems.erase(result);
-  }
-
-  return static_cast <SpeciesType*> (item);
+  return static_cast <SpeciesType*> (removeItemBySId(sid));
 }
 
 
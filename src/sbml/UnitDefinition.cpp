@@ -244,6 +244,7 @@ UnitDefinition::setId (const std::string& sid)
   }
   else
   {
+    updateParentIdIndex(sid);
     mId = sid;
     return LIBSBML_OPERATION_SUCCESS;
   }
@@ -267,6 +268,7 @@ UnitDefinition::setName (const std::string& name)
     }
     else
     {
+      updateParentIdIndex(name);
       mId = name;
       return LIBSBML_OPERATION_SUCCESS;
     }
@@ -287,6 +289,7 @@ UnitDefinition::unsetName ()
 {
   if (getLevel() == 1) 
   {
+    updateParentIdIndex("");
     mId.erase();
   }
   else 
@@ -2301,19 +2304,6 @@ ListOfUnitDefinitions::get(unsigned int n) const
 }
 
 
-/**
- * Used by ListOf::get() to lookup an SBase based by its id.
- */
-struct IdEqUD : public unary_function<SBase*, bool>
-{
-  const string& mId;
-
-  IdEqUD (const string& id) : mId(id) { }
-  bool operator() (SBase* sb) 
-       { return static_cast <UnitDefinition *> (sb)->getId() == mId; }
-};
-
-
 /* return item by id */
 UnitDefinition*
 ListOfUnitDefinitions::get (const std::string& sid)
@@ -2327,11 +2317,7 @@ ListOfUnitDefinitions::get (const std::string& sid)
 const UnitDefinition*
 ListOfUnitDefinitions::get (const std::string& sid) const
 {
-  vector<SBase*>::const_iterator result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqUD(sid) );
-  return (result == mItems.end()) ? NULL : 
-                   static_cast <UnitDefinition*> (*result);
+  return static_cast <const UnitDefinition*> (getItemBySId(sid));
 }
 
 
@@ -2361,18 +2347,7 @@ ListOfUnitDefinitions::remove (unsigned int n)
 UnitDefinition*
 ListOfUnitDefinitions::remove (const std::string& sid)
 {
-  SBase* item = NULL;
-  ListItemIter result;
-
-  result = find_if( mItems.begin(), mItems.end(), IdEqUD(sid) );
-
-  if (result != mItems.end())
-  {
-    item = *result;
-    mItems.erase(result);
-  }
-
-  return static_cast <UnitDefinition*> (item);
+  return static_cast <UnitDefinition*> (removeItemBySId(sid));
 }
 
 
@@ -260,6 +260,11 @@ double ASTBasePlugin::evaluateASTNode(const ASTNode * node, const Model * m) con
   return numeric_limits<double>::quiet_NaN();
 }
 
+double ASTBasePlugin::evaluateASTNode(const ASTNode * node, const EvaluationContext& context) const
+{
+  return evaluateASTNode(node, context.getModel());
+}
+
 UnitDefinition * ASTBasePlugin::getUnitDefinitionFromPackage(UnitFormulaFormatter* uff, const ASTNode * node, bool inKL, int reactNo) const
 {
   return NULL;
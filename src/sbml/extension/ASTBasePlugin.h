@@ -67,6 +67,7 @@ LIBSBML_CPP_NAMESPACE_BEGIN
 class UnitDefinition;
 class UnitFormulaFormatter;
 class ArgumentsUnitsCheck;
+class EvaluationContext;
 
 
 struct ASTNodeValues_t {
@@ -102,6 +103,21 @@ public:
   virtual bool isMathMLNodeTag(ASTNodeType_t type) const;
   virtual ExtendedMathType_t getExtendedMathType() const;
   virtual double evaluateASTNode(const ASTNode * node, const Model * m = NULL) const;
+#ifndef SWIG
+  /**
+   * Evaluates the given node using the values and model of the given
+   * context; the default implementation calls evaluateASTNode(node, m)
+   * with the model of the context.
+   *
+   * @note Adding this virtual function changed the layout of the virtual
+   * table of ASTBasePlugin, so that plugins compiled against earlier
+   * versions of libSBML have to be recompiled.  Subclasses overriding only
+   * evaluateASTNode(const ASTNode*, const Model*) should add
+   * <code>using ASTBasePlugin::evaluateASTNode;</code> so that this
+   * overload is not hidden.
+   */
+  virtual double evaluateASTNode(const ASTNode * node, const EvaluationContext& context) const;
+#endif
   virtual UnitDefinition * getUnitDefinitionFromPackage(UnitFormulaFormatter* uff, const ASTNode * node, bool inKL, int reactNo) const;
 
   const ASTNodeValues_t* getASTNodeValue(unsigned int n) const;
@@ -239,7 +239,7 @@ LIBSBML_EXTERN
 ASTNode::ASTNode (ASTNodeType_t type)
 {
   unsetSemanticsFlag();
-  mDefinitionURL = new XMLAttributes();
+  mDefinitionURL = NULL;
   mReal          = 0;
   mExponent      = 0;
   mType          = AST_UNKNOWN;
@@ -259,7 +259,7 @@ ASTNode::ASTNode (ASTNodeType_t type)
   //setType(type);
 
   mChildren             = new List;
-  mSemanticsAnnotations = new List;
+  mSemanticsAnnotations = NULL;
   // only load plugins when we need to
   //if (type > AST_END_OF_CORE && type < AST_UNKNOWN)
   //{
@@ -285,7 +285,7 @@ LIBSBML_EXTERN
 ASTNode::ASTNode (Token_t* token)
 {
   unsetSemanticsFlag();
-  mDefinitionURL = new XMLAttributes();
+  mDefinitionURL = NULL;
   mReal          = 0;
   mExponent      = 0;
   mType          = AST_UNKNOWN;
@@ -302,7 +302,7 @@ ASTNode::ASTNode (Token_t* token)
   mUserData      = NULL;
 
   mChildren             = new List;
-  mSemanticsAnnotations = new List;
+  mSemanticsAnnotations = NULL;
 
   if (token != NULL)
   {
@@ -360,10 +360,10 @@ ASTNode::ASTNode (const ASTNode& orig) :
  ,mReal                 ( orig.mReal )
  ,mDenominator          ( orig.mDenominator )
  ,mExponent             ( orig.mExponent )
- ,mDefinitionURL        ( orig.mDefinitionURL->clone() )	
+ ,mDefinitionURL        ( NULL )
  ,hasSemantics          ( orig.hasSemantics )
  ,mChildren             ( new List() )
- ,mSemanticsAnnotations ( new List() )
+ ,mSemanticsAnnotations ( NULL )
  ,mParentSBMLObject     ( orig.mParentSBMLObject )
  ,mUnits                ( orig.mUnits)
  ,mId                   ( orig.mId)
@@ -377,6 +377,11 @@ ASTNode::ASTNode (const ASTNode& orig) :
     mName = safe_strdup(orig.mName);
   }
 
+  if (orig.mDefinitionURL != NULL)
+  {
+    mDefinitionURL = orig.mDefinitionURL->clone();
+  }
+
   for (unsigned int c = 0; c < orig.getNumChildren(); ++c)
   {
     addChild( orig.getChild(c)->deepCopy() );
@@ -439,10 +444,7 @@ ASTNode& ASTNode::operator=(const ASTNode& rhs)
       addChild( rhs.getChild(c)->deepCopy() );
     }
 
-    size = mSemanticsAnnotations->getSize();
-    while (size--)  delete static_cast<XMLNode*>(mSemanticsAnnotations->remove(0) );
-    delete mSemanticsAnnotations;
-    mSemanticsAnnotations = new List();
+    clearSemanticsAnnotations();
 
     for (unsigned int c = 0; c < rhs.getNumSemanticsAnnotations(); ++c)
     {
@@ -450,7 +452,8 @@ ASTNode& ASTNode::operator=(const ASTNode& rhs)
     }
     
     delete mDefinitionURL;
-    mDefinitionURL        = rhs.mDefinitionURL->clone();	
+    mDefinitionURL        = (rhs.mDefinitionURL != NULL) ?
+                            rhs.mDefinitionURL->clone() : NULL;
     clearPlugins();
     mPlugins.resize(rhs.mPlugins.size());
     transform(rhs.mPlugins.begin(), rhs.mPlugins.end(),
@@ -471,9 +474,7 @@ ASTNode::~ASTNode ()
   while (size--) delete static_cast<ASTNode*>( mChildren->remove(0) );
   delete mChildren;
 
-  size = mSemanticsAnnotations->getSize();
-  while (size--)  delete static_cast<XMLNode*>(mSemanticsAnnotations->remove(0) );
-  delete mSemanticsAnnotations;
+  clearSemanticsAnnotations();
 
   delete mDefinitionURL;
   
@@ -1049,6 +1050,10 @@ ASTNode::addSemanticsAnnotation (XMLNode* sAnnotation)
   {
     return LIBSBML_OPERATION_FAILED;
   }
+  if (mSemanticsAnnotations == NULL)
+  {
+    mSemanticsAnnotations = new List;
+  }
   mSemanticsAnnotations->add(sAnnotation);
   return LIBSBML_OPERATION_SUCCESS;
 }
@@ -1061,7 +1066,7 @@ LIBSBML_EXTERN
 unsigned int 
 ASTNode::getNumSemanticsAnnotations () const
 {
-  return mSemanticsAnnotations->getSize();
+  return (mSemanticsAnnotations != NULL) ? mSemanticsAnnotations->getSize() : 0;
 }
 
 
@@ -1073,6 +1078,10 @@ LIBSBML_EXTERN
 XMLNode* 
 ASTNode::getSemanticsAnnotation (unsigned int n) const
 {
+  if (mSemanticsAnnotations == NULL)
+  {
+    return NULL;
+  }
   return static_cast<XMLNode*>( mSemanticsAnnotations->get(n) );
 }
 
@@ -2194,19 +2203,19 @@ ASTNode::setType (ASTNodeType_t type)
     //{
       mReal = 6.02214179e23;
     //}
-    mDefinitionURL->clear();
+    getDefinitionURL()->clear();
     mDefinitionURL->add("definitionURL", 
                         "http://www.sbml.org/sbml/symbols/avogadro");
   }
   else if (type == AST_NAME_TIME)
   {
-    mDefinitionURL->clear();
+    getDefinitionURL()->clear();
     mDefinitionURL->add("definitionURL", 
                         "http://www.sbml.org/sbml/symbols/time");
   }
   else if (type == AST_FUNCTION_DELAY)
   {
-    mDefinitionURL->clear();
+    getDefinitionURL()->clear();
     mDefinitionURL->add("definitionURL", 
                         "http://www.sbml.org/sbml/symbols/delay");
   }
@@ -2273,13 +2282,19 @@ ASTNode::setType (ASTNodeType_t type)
   {
     mType = AST_UNKNOWN;
     mChar = 0;
-    mDefinitionURL->clear();
+    if (mDefinitionURL != NULL)
+    {
+      mDefinitionURL->clear();
+    }
     return LIBSBML_INVALID_ATTRIBUTE_VALUE;
   }
 
   if (clearDefinitionURL == true && getSemanticsFlag() == false)
   {
-    mDefinitionURL->clear();
+    if (mDefinitionURL != NULL)
+    {
+      mDefinitionURL->clear();
+    }
   }
 
     
@@ -2544,7 +2559,7 @@ ASTNode::setDefinitionURL(XMLAttributes url)
 int 
 ASTNode::setDefinitionURL(const std::string& url)
 {
-  mDefinitionURL->clear();
+  getDefinitionURL()->clear();
   mDefinitionURL->add("definitionURL", url);
   return LIBSBML_OPERATION_SUCCESS;
 }
@@ -2924,6 +2939,12 @@ LIBSBML_EXTERN
 XMLAttributes*
 ASTNode::getDefinitionURL() const
 {
+  // most nodes never carry a definitionURL, so the attributes are only
+  // created the first time somebody asks for them
+  if (mDefinitionURL == NULL)
+  {
+    mDefinitionURL = new XMLAttributes();
+  }
   return mDefinitionURL;
 }
 
@@ -3496,6 +3517,20 @@ void ASTNode::clearPlugins()
 }
 
 
+void ASTNode::clearSemanticsAnnotations()
+{
+  if (mSemanticsAnnotations == NULL)
+  {
+    return;
+  }
+
+  unsigned int size = mSemanticsAnnotations->getSize();
+  while (size--)  delete static_cast<XMLNode*>(mSemanticsAnnotations->remove(0) );
+  delete mSemanticsAnnotations;
+  mSemanticsAnnotations = NULL;
+}
+
+
 #endif /* __cplusplus */
 
 
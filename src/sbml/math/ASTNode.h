@@ -2289,7 +2289,9 @@ protected:
   long mDenominator;
   long mExponent;
 
-  XMLAttributes* mDefinitionURL;
+  // created on first use; most nodes have neither a definitionURL
+  // nor semantics annotations
+  mutable XMLAttributes* mDefinitionURL;
   bool hasSemantics;
 
   List *mChildren;
@@ -2327,6 +2329,7 @@ protected:
 
 private:
   void clearPlugins();
+  void clearSemanticsAnnotations();
 };
 
 LIBSBML_CPP_NAMESPACE_END
@@ -99,6 +99,7 @@ public:
 
   //virtual const char* getConstCharFor(ASTNodeType_t type) const;
   virtual bool hasCorrectNamespace(SBMLNamespaces* namespaces) const;
+  using ASTBasePlugin::evaluateASTNode;
   virtual double evaluateASTNode(const ASTNode * node, const Model * m = NULL) const;
   virtual UnitDefinition * getUnitDefinitionFromPackage(UnitFormulaFormatter* uff, const ASTNode * node, bool inKL, int reactNo) const;
   virtual bool isMathMLNodeTag(const std::string& node) const;
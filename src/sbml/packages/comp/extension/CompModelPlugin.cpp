@@ -43,6 +43,8 @@
 
 #include <sbml/util/ElementFilter.h>
 #include <sbml/util/PrefixTransformer.h>
+#include <sbml/util/ThreadSupport.h>
+#include <sbml/packages/comp/util/SBMLResolverRegistry.h>
 
 #ifdef LIBSBML_HAS_PACKAGE_FBC
 #include <sbml/packages/fbc/extension/FbcModelPlugin.h>
@@ -61,6 +63,7 @@ CompModelPlugin::CompModelPlugin (const std::string &uri, const std::string &pre
   , mDivider("__")
   , mRemoved()
   , mTransformer(NULL)
+  , mNumInstantiationThreads(1)
 {
   connectToChild();
 }
@@ -73,6 +76,7 @@ CompModelPlugin::CompModelPlugin(const CompModelPlugin& orig)
   , mDivider("__")
   , mRemoved() //If we're making a copy, the list of things we've removed is new.
   , mTransformer(orig.mTransformer)
+  , mNumInstantiationThreads(orig.mNumInstantiationThreads)
 {
   connectToChild();
 }
@@ -93,6 +97,7 @@ CompModelPlugin::operator=(const CompModelPlugin& orig)
     mDivider = orig.mDivider;
     mRemoved.clear(); //If we're making a copy, the list of things we've removed is new.
     mTransformer = orig.mTransformer;
+    mNumInstantiationThreads = orig.mNumInstantiationThreads;
     connectToChild();
   }
   return *this;
@@ -727,6 +732,14 @@ CompModelPlugin::instantiateSubmodels()
   
   int ret;
 
+  if (mNumInstantiationThreads > 1)
+  {
+    ret = instantiateSubmodelsConcurrently();
+    if (ret != LIBSBML_OPERATION_SUCCESS) {
+      return ret;
+    }
+  }
+
   // First we instantiate all the submodels.  
   // This acts recursively downward through the stack.
   for (unsigned int sub=0; sub<mListOfSubmodels.size(); sub++) 
@@ -799,6 +812,108 @@ CompModelPlugin::instantiateSubmodels()
   return LIBSBML_OPERATION_SUCCESS;
 }
 
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Instantiates one submodel, on whichever thread runTasks() chooses.
+ */
+class InstantiationTask
+{
+public:
+  explicit InstantiationTask(Submodel* submodel)
+    : mSubmodel(submodel), mResult(LIBSBML_OPERATION_FAILED) {}
+
+  void run()
+  {
+    mResult = mSubmodel->instantiateWithoutCallbacks();
+  }
+
+  Submodel* mSubmodel;
+  int mResult;
+};
+
+
+int
+CompModelPlugin::instantiateSubmodelsConcurrently()
+{
+  SBMLDocument* doc = getSBMLDocument();
+  if (doc == NULL)
+  {
+    return LIBSBML_OPERATION_SUCCESS;
+  }
+
+  vector<InstantiationTask*> tasks;
+  for (unsigned int sub=0; sub<mListOfSubmodels.size(); sub++) 
+  {
+    Submodel* submodel = mListOfSubmodels.get(sub);
+    if (static_cast<const Submodel*>(submodel)->getInstantiation() == NULL)
+    {
+      tasks.push_back(new InstantiationTask(submodel));
+    }
+  }
+
+  // the resolvers are set up on first use, which must not happen on
+  // several threads at once
+  SBMLResolverRegistry::getInstance();
+
+  // The errors of a submodel that fails are logged when it is
+  // instantiated again below, in the same order as without threads.
+  SBMLErrorLog* log = doc->getErrorLog();
+  XMLErrorSeverityOverride_t severity = log->getSeverityOverride();
+  log->setSeverityOverride(LIBSBML_OVERRIDE_DONT_LOG);
+
+  const string packageState = Submodel::getPackageState(doc);
+  try
+  {
+    runTasks(tasks, mNumInstantiationThreads);
+  }
+  catch (...)
+  {
+    log->setSeverityOverride(severity);
+    for (size_t n = 0; n < tasks.size(); ++n)
+    {
+      delete tasks[n];
+    }
+    throw;
+  }
+  log->setSeverityOverride(severity);
+
+  // Now do what instantiating the submodels one after the other would
+  // have done on top of that: call the processing callbacks in order, and
+  // stop at the first submodel that cannot be instantiated.
+  int ret = LIBSBML_OPERATION_SUCCESS;
+  for (size_t n = 0; n < tasks.size(); ++n)
+  {
+    Submodel* submodel = tasks[n]->mSubmodel;
+    if (ret != LIBSBML_OPERATION_SUCCESS)
+    {
+      submodel->clearInstantiation();
+    }
+    else if (tasks[n]->mResult != LIBSBML_OPERATION_SUCCESS ||
+             Submodel::getPackageState(doc) != packageState)
+    {
+      submodel->clearInstantiation();
+      if (submodel->getInstantiation() == NULL)
+      {
+        //'getInstantiation' already sets any errors that might have occurred.
+        ret = LIBSBML_OPERATION_FAILED;
+      }
+    }
+    else
+    {
+      submodel->invokeProcessingCallbacks(packageState);
+      if (static_cast<const Submodel*>(submodel)->getInstantiation() == NULL)
+      {
+        ret = LIBSBML_OPERATION_FAILED;
+      }
+    }
+    delete tasks[n];
+  }
+
+  return ret;
+}
+/** @endcond */
+
 int CompModelPlugin::saveAllReferencedElements()
 {
   set<SBase*> norefs;
@@ -1439,6 +1554,22 @@ CompModelPlugin::unsetTransformer()
 }
 
 
+/** @cond doxygenLibsbmlInternal */
+void
+CompModelPlugin::setNumInstantiationThreads(unsigned int numThreads)
+{
+  mNumInstantiationThreads = numThreads;
+}
+
+
+unsigned int
+CompModelPlugin::getNumInstantiationThreads() const
+{
+  return mNumInstantiationThreads;
+}
+/** @endcond */
+
+
 
 /** @cond doxygenLibsbmlInternal */
 std::set<SBase*>* 
@@ -585,6 +585,20 @@ public:
    */
   void unsetTransformer();
 
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Sets the number of threads instantiateSubmodels() may use to
+   * instantiate the submodels of this model.  With @c 1 (the default),
+   * they are instantiated one after the other.
+   */
+  void setNumInstantiationThreads(unsigned int numThreads);
+
+  /**
+   * @return the number of threads instantiateSubmodels() may use.
+   */
+  unsigned int getNumInstantiationThreads() const;
+  /** @endcond */
+
 protected:
 
   /**
@@ -660,6 +674,11 @@ protected:
    * in previous releases. 
    */
   PrefixTransformer* mTransformer;
+
+  /*
+   * The number of threads instantiateSubmodels() may use.
+   */
+  unsigned int mNumInstantiationThreads;
   /** @endcond */
 
 private:
@@ -677,6 +696,12 @@ private:
    */
   virtual int saveAllReferencedElements();
 
+  /*
+   * Instantiates the submodels of this Model on several threads, with the
+   * same result as instantiating them one after the other.
+   */
+  int instantiateSubmodelsConcurrently();
+
   /*
    * Renames all ids of all elements in the instantiated submodel (SIds,
    * MetaIDs, UnitSIds, and PortSIDs) using the ID of that Submodel,
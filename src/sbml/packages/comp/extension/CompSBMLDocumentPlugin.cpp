@@ -61,6 +61,8 @@ CompSBMLDocumentPlugin::CompSBMLDocumentPlugin (const string &uri, const string
   , mListOfModelDefinitions(compns)
   , mListOfExternalModelDefinitions(compns)
   , mURIToDocumentMap()
+  , mReferencedModels()
+  , mURIDocumentStore (NULL)
   , mCheckingDummyDoc (false)
   , mFlattenAndCheck (true)
   , mOverrideCompFlattening (false)
@@ -74,6 +76,8 @@ CompSBMLDocumentPlugin::CompSBMLDocumentPlugin(const CompSBMLDocumentPlugin& ori
   , mListOfModelDefinitions(orig.mListOfModelDefinitions)
   , mListOfExternalModelDefinitions(orig.mListOfExternalModelDefinitions)
   , mURIToDocumentMap() //The documents are owning pointers, so don't copy them.
+  , mReferencedModels()
+  , mURIDocumentStore (NULL)
   , mCheckingDummyDoc (orig.mCheckingDummyDoc)
   , mFlattenAndCheck (orig.mFlattenAndCheck)
   , mOverrideCompFlattening (orig.mOverrideCompFlattening)
@@ -91,6 +95,8 @@ CompSBMLDocumentPlugin::operator=(const CompSBMLDocumentPlugin& orig)
     mListOfModelDefinitions = orig.mListOfModelDefinitions;
     mListOfExternalModelDefinitions = orig.mListOfExternalModelDefinitions;
     mURIToDocumentMap.clear(); //Don't copy the pointers to this object, as they are owning pointers
+    mReferencedModels.clear();
+    mURIDocumentStore = NULL;
 
     mCheckingDummyDoc = orig.mCheckingDummyDoc;
     mFlattenAndCheck = orig.mFlattenAndCheck;
@@ -679,21 +685,97 @@ CompSBMLDocumentPlugin::getSBMLDocumentFromURI(const std::string& uri)
   string resolvedURI = resolved->getUri();
   delete resolved;
 
-  map<string, SBMLDocument*>::iterator stored = mURIToDocumentMap.find(resolvedURI);
-  if (stored == mURIToDocumentMap.end()) 
+  // the documents resolved from one document and from all the documents
+  // it refers to are kept together, so each of them is read only once
+  CompSBMLDocumentPlugin* store = getURIDocumentStore();
+
+  map<string, SBMLDocument*>::iterator stored = store->mURIToDocumentMap.find(resolvedURI);
+  if (stored == store->mURIToDocumentMap.end()) 
   {
     SBMLDocument* doc = registry.resolve(uri, mSBML->getLocationURI());
 
     if (doc==NULL) 
       return NULL;
 
-    mURIToDocumentMap.insert(make_pair(resolvedURI, doc));
+    store->mURIToDocumentMap.insert(make_pair(resolvedURI, doc));
     doc->setLocationURI(resolvedURI);
 
+    CompSBMLDocumentPlugin* docplugin = 
+      dynamic_cast<CompSBMLDocumentPlugin*>(doc->getPlugin(getPackageName()));
+    if (docplugin != NULL)
+    {
+      docplugin->mURIDocumentStore = store;
+    }
+
     return doc;
   }
   return stored->second;
 }
+
+
+Model*
+CompSBMLDocumentPlugin::getStoredReferencedModel(const std::string& key)
+{
+  CompSBMLDocumentPlugin* store = getURIDocumentStore();
+
+  map<string, pair<SBMLDocument*, string> >::iterator stored = 
+    store->mReferencedModels.find(key);
+  if (stored == store->mReferencedModels.end())
+  {
+    return NULL;
+  }
+
+  // look the model up again, in case it has been removed since
+  SBMLDocument* doc = stored->second.first;
+  const string& modelId = stored->second.second;
+  if (modelId.empty())
+  {
+    return doc->getModel();
+  }
+
+  CompSBMLDocumentPlugin* docplugin = 
+    static_cast<CompSBMLDocumentPlugin*>(doc->getPlugin(getPackageName()));
+  return docplugin == NULL ? NULL : docplugin->getModelDefinition(modelId);
+}
+
+
+void
+CompSBMLDocumentPlugin::storeReferencedModel(const std::string& key, 
+                                             Model* model)
+{
+  SBMLDocument* doc = model->getSBMLDocument();
+  if (doc == NULL)
+  {
+    return;
+  }
+
+  string modelId;
+  if (doc->getModel() != model)
+  {
+    if (model->getTypeCode() != SBML_COMP_MODELDEFINITION)
+    {
+      return;
+    }
+    modelId = model->getId();
+  }
+
+  CompSBMLDocumentPlugin* store = getURIDocumentStore();
+  store->mReferencedModels[key] = make_pair(doc, modelId);
+}
+
+
+Mutex&
+CompSBMLDocumentPlugin::getURIDocumentMutex()
+{
+  return getURIDocumentStore()->mURIDocumentMutex;
+}
+
+
+CompSBMLDocumentPlugin*
+CompSBMLDocumentPlugin::getURIDocumentStore()
+{
+  return mURIDocumentStore != NULL ? mURIDocumentStore : this;
+}
 /** @endcond */
 
 
@@ -718,6 +800,7 @@ CompSBMLDocumentPlugin::clearStoredURIDocuments()
     delete mi->second;
   }
   mURIToDocumentMap.clear();
+  mReferencedModels.clear();
 }
 
 /** @cond doxygenLibsbmlInternal */
@@ -69,6 +69,7 @@
 #include <sbml/xml/XMLOutputStream.h>
 #include <sbml/extension/SBasePlugin.h>
 #include <sbml/extension/SBMLDocumentPlugin.h>
+#include <sbml/util/ThreadSupport.h>
 
 #include <iostream>
 #include <string>
@@ -93,6 +94,10 @@ protected:
   ListOfModelDefinitions  mListOfModelDefinitions;
   ListOfExternalModelDefinitions  mListOfExternalModelDefinitions;
   std::map<std::string, SBMLDocument*> mURIToDocumentMap;
+  std::map<std::string, std::pair<SBMLDocument*, std::string> >
+                                       mReferencedModels;
+  CompSBMLDocumentPlugin*              mURIDocumentStore;
+  Mutex                                mURIDocumentMutex;
   /** @endcond */
 
 public:
@@ -668,6 +673,34 @@ public:
    */
   virtual SBMLDocument* getSBMLDocumentFromURI(const std::string& uri);
 
+
+  /**
+   * Returns the model stored under the given key by
+   * storeReferencedModel(), or @c NULL if there is none.
+   *
+   * Submodels referring to the same external model definition look up the
+   * model it resolves to here, rather than resolving its source again.
+   * Like the documents returned by getSBMLDocumentFromURI(), the models
+   * are kept by the plugin of the document all others were resolved from.
+   */
+  Model* getStoredReferencedModel(const std::string& key);
+
+
+  /**
+   * Stores the given model, which must belong to a document returned by
+   * getSBMLDocumentFromURI(), under the given key.
+   */
+  void storeReferencedModel(const std::string& key, Model* model);
+
+
+  /**
+   * Returns the mutex to hold while using getSBMLDocumentFromURI(),
+   * getStoredReferencedModel() or storeReferencedModel() from submodels
+   * instantiated on several threads.  It belongs to the same plugin as the
+   * documents and models these functions keep.
+   */
+  Mutex& getURIDocumentMutex();
+
   /** @endcond */
 
 private:
@@ -690,6 +723,14 @@ private:
    */
   virtual void clearStoredURIDocuments();
 
+
+  /**
+   * Returns the plugin keeping the documents resolved for this one: the
+   * plugin of the document all the others were resolved from, so that
+   * each source is read only once for the whole hierarchy.
+   */
+  CompSBMLDocumentPlugin* getURIDocumentStore();
+
   
   /** variables and functions for consistency checking **/
 
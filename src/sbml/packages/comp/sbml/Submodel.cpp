@@ -30,6 +30,7 @@
 
 #include <iostream>
 #include <set>
+#include <sstream>
 
 #include <sbml/SBMLVisitor.h>
 #include <sbml/RateRule.h>
@@ -775,6 +776,23 @@ Submodel::connectToChild()
 
 int 
 Submodel::instantiate()
+{
+  return instantiateModel(true);
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+int
+Submodel::instantiateWithoutCallbacks()
+{
+  return instantiateModel(false);
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+int
+Submodel::instantiateModel(bool invokeCallbacks)
 {
   SBMLDocument* doc = getSBMLDocument();
   SBMLDocument* rootdoc = doc;
@@ -867,7 +885,40 @@ Submodel::instantiate()
       mInstantiationOriginalURI = "";
       return LIBSBML_OPERATION_FAILED;
     }
-    mInstantiatedModel = extmod->getReferencedModel(rootdoc, parents);
+    {
+      // the documents read for external models are shared by all the
+      // submodels being instantiated, possibly on several threads
+      MutexLock lock(docplugin->getURIDocumentMutex());
+
+      // every submodel referring to the same source and model resolves
+      // to the same model, which only needs to be found once
+      stringstream key;
+      key << doc->getLocationURI() << '\n' << extmod->getSource() << '\n'
+          << extmod->getModelRef() << '\n' << rootdoc->getLevel() << ' '
+          << rootdoc->getVersion();
+
+      mInstantiatedModel = docplugin->getStoredReferencedModel(key.str());
+      if (mInstantiatedModel == NULL)
+      {
+        mInstantiatedModel = extmod->getReferencedModel(rootdoc, parents);
+        if (mInstantiatedModel != NULL)
+        {
+          docplugin->storeReferencedModel(key.str(), mInstantiatedModel);
+        }
+      }
+
+      // enabling 'comp' on the copy below would enable it on the whole
+      // external document, which other submodels may be copying from,
+      // so this is done beforehand
+      if (mInstantiatedModel != NULL)
+      {
+        SBMLDocument* extdoc = mInstantiatedModel->getSBMLDocument();
+        if (extdoc != NULL && !extdoc->isPackageURIEnabled(getPackageURI()))
+        {
+          extdoc->enablePackage(getPackageURI(), getPrefix(), true);
+        }
+      }
+    }
     if (mInstantiatedModel == NULL) 
     {
       string error = "In Submodel::instantiate, unable to instantiate submodel '" + getId() + "' because the external model definition it referenced (model '" + getModelRef() +"') could not be resolved.";
@@ -917,14 +968,11 @@ Submodel::instantiate()
   }
 
   // call all registered callbacks
-  std::vector<ModelProcessingCallbackData*>::iterator it = mProcessingCBs.begin();
-  while(it != mProcessingCBs.end())
+  if (invokeCallbacks)
   {
-    ModelProcessingCallbackData* current = *it;
-    int result = current->cb(mInstantiatedModel, rootdoc->getErrorLog(), current->data);
+    int result = callProcessingCallbacks(rootdoc);
     if (result != LIBSBML_OPERATION_SUCCESS)
       return result;
-    ++it;
   }
 
   
@@ -949,7 +997,8 @@ Submodel::instantiate()
   for (unsigned int sub=0; sub<instmodplug->getNumSubmodels(); sub++) 
   {
     Submodel* instsub = instmodplug->getSubmodel(sub);
-    int ret = instsub->instantiate();
+    int ret = invokeCallbacks ? instsub->instantiate()
+                              : instsub->instantiateWithoutCallbacks();
     if (ret != LIBSBML_OPERATION_SUCCESS) {
       //'instantiate' already sets its own error messages.
       delete mInstantiatedModel;
@@ -961,6 +1010,112 @@ Submodel::instantiate()
 
   return LIBSBML_OPERATION_SUCCESS;
 }
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+int
+Submodel::invokeProcessingCallbacks(const std::string& packageState)
+{
+  if (mInstantiatedModel == NULL)
+  {
+    return LIBSBML_INVALID_OBJECT;
+  }
+
+  SBMLDocument* rootdoc = getRootDocument();
+  CompModelPlugin* instmodplug = 
+    static_cast<CompModelPlugin*>(mInstantiatedModel->getPlugin(getPrefix()));
+
+  int result = callProcessingCallbacks(rootdoc);
+  if (result != LIBSBML_OPERATION_SUCCESS)
+  {
+    // instantiate() would have stopped before the submodels
+    for (unsigned int sub = 0; instmodplug != NULL && 
+         sub < instmodplug->getNumSubmodels(); sub++)
+    {
+      instmodplug->getSubmodel(sub)->clearInstantiation();
+    }
+    return result;
+  }
+
+  if (instmodplug == NULL)
+    return LIBSBML_OPERATION_SUCCESS;
+
+  for (unsigned int sub=0; sub<instmodplug->getNumSubmodels(); sub++) 
+  {
+    Submodel* instsub = instmodplug->getSubmodel(sub);
+    int ret;
+    if (getPackageState(rootdoc) == packageState)
+    {
+      ret = instsub->invokeProcessingCallbacks(packageState);
+    }
+    else
+    {
+      ret = instsub->instantiate();
+    }
+    if (ret != LIBSBML_OPERATION_SUCCESS) {
+      delete mInstantiatedModel;
+      mInstantiatedModel = NULL;
+      mInstantiationOriginalURI = "";
+      return ret;
+    }
+  }
+
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+std::string
+Submodel::getPackageState(const SBMLDocument* doc)
+{
+  stringstream state;
+  if (doc == NULL)
+  {
+    return state.str();
+  }
+
+  const XMLNamespaces* xmlns = doc->getNamespaces();
+  for (int n = 0; xmlns != NULL && n < xmlns->getNumNamespaces(); n++)
+  {
+    state << xmlns->getURI(n) << ' ';
+  }
+  state << doc->getNumPlugins() << ' ' << doc->getNumDisabledPlugins();
+
+  return state.str();
+}
+
+
+int
+Submodel::callProcessingCallbacks(SBMLDocument* rootdoc)
+{
+  std::vector<ModelProcessingCallbackData*>::iterator it = mProcessingCBs.begin();
+  while(it != mProcessingCBs.end())
+  {
+    ModelProcessingCallbackData* current = *it;
+    int result = current->cb(mInstantiatedModel, rootdoc->getErrorLog(), current->data);
+    if (result != LIBSBML_OPERATION_SUCCESS)
+      return result;
+    ++it;
+  }
+
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+SBMLDocument*
+Submodel::getRootDocument()
+{
+  SBMLDocument* rootdoc = getSBMLDocument();
+  SBase* parent = getParentSBMLObject();
+  while (parent != NULL && parent->getTypeCode() != SBML_DOCUMENT) {
+    rootdoc = parent->getSBMLDocument();
+    parent = parent->getParentSBMLObject();
+  }
+
+  return rootdoc;
+}
+/** @endcond */
+
 
 int Submodel::performDeletions()
 {
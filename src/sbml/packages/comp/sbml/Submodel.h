@@ -847,6 +847,35 @@ public:
    * @param cb the callback to be removed.
    */
   static void removeProcessingCallback(ModelProcessingCallback cb);
+
+  /**
+   * Does what instantiate() does, except for calling the registered
+   * processing callbacks, here or for any of the submodels instantiated
+   * with this one.  Several Submodel objects of a model may be instantiated
+   * this way on different threads at the same time, as long as the
+   * documents involved are not otherwise changed meanwhile.
+   */
+  int instantiateWithoutCallbacks();
+
+  /**
+   * Calls the registered processing callbacks for a model instantiated by
+   * instantiateWithoutCallbacks(), and for the instantiations of its
+   * submodels, in the order in which instantiate() would have called them.
+   *
+   * The callbacks may change the packages of the document being
+   * instantiated (see getPackageState()).  If the state of that document
+   * is no longer @p packageState, the submodels still to be processed are
+   * instantiated again, so that they are as instantiate() would have made
+   * them.
+   */
+  int invokeProcessingCallbacks(const std::string& packageState);
+
+  /**
+   * Returns a summary of the namespaces and plugins of the given document.
+   * Submodels instantiated from that document are only expected to be the
+   * same as long as this does not change.
+   */
+  static std::string getPackageState(const SBMLDocument* doc);
   /** @endcond */
 
 protected:
@@ -887,6 +916,23 @@ protected:
   /** @endcond */
 
 private:
+  /**
+   * Internal implementation of instantiate() and
+   * instantiateWithoutCallbacks().
+   */
+  int instantiateModel(bool invokeCallbacks);
+
+  /**
+   * Calls the registered processing callbacks for the instantiated model.
+   */
+  int callProcessingCallbacks(SBMLDocument* rootdoc);
+
+  /**
+   * Returns the document of the outermost model this Submodel belongs to,
+   * where the errors of instantiation are logged.
+   */
+  SBMLDocument* getRootDocument();
+
   /**
    * Internal function to convert time and extent with the given ASTNodes.
    */
@@ -293,9 +293,8 @@ START_TEST (test_comp_submodel_deletion)
   {
     fail("Submodel_addDeletion(...) did not make a copy of the deletion.");
   }
-  Deletion_free(getdel);
 
-  Submodel_removeDeletion(P, 0);
+  Deletion_free(Submodel_removeDeletion(P, 0));
   
   fail_unless( Submodel_getDeletion(P, 0) == NULL);
   fail_unless( Submodel_getNumDeletions(P)==0 );
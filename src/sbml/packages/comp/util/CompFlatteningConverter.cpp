@@ -127,6 +127,8 @@ CompFlatteningConverter::getDefaultProperties() const
     "specify whether to strip any unflattenable packages ignored by 'abortIfUnflattenable'");
   prop.addOption("stripPackages", "", 
     "comma separated list of packages to be stripped before flattening is attempted");
+  prop.addOption("numThreads", 1,
+    "the number of threads to instantiate the submodels with");
   return prop;
 }
 
@@ -389,7 +391,10 @@ CompFlatteningConverter::performConversion()
   mainDoc.abortForRequiredOnly = getAbortForRequired(); 
  
   Submodel::addProcessingCallback(&EnablePackageOnParentDocument, &(mainDoc));
+  unsigned int numThreads = modelPlugin->getNumInstantiationThreads();
+  modelPlugin->setNumInstantiationThreads(getNumThreads());
   Model* flatmodel = modelPlugin->flattenModel();
+  modelPlugin->setNumInstantiationThreads(numThreads);
   
 
   if (flatmodel == NULL) 
@@ -880,6 +885,23 @@ CompFlatteningConverter::getPerformValidation() const
 }
 /** @endcond */
 
+/** @cond doxygenLibsbmlInternal */
+unsigned int
+CompFlatteningConverter::getNumThreads() const
+{
+  if (getProperties() == NULL || 
+      getProperties()->hasOption("numThreads") == false)
+  {
+    return 1;
+  }
+  else
+  {
+    int numThreads = getProperties()->getIntValue("numThreads");
+    return numThreads > 1 ? (unsigned int)numThreads : 1;
+  }
+}
+/** @endcond */
+
 /** @cond doxygenLibsbmlInternal */
 bool
 CompFlatteningConverter::getAbortForAll() const
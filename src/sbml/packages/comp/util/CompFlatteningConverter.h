@@ -199,6 +199,11 @@
  *     (for instance, if an element is replaced by something that does not
  *     exist), but no separate validation steps are performed.
  *
+ * @li @em "numThreads": if this option is set to a number greater than
+ *     @c 1, the Submodel objects of the Model are instantiated on up to that
+ *     many threads at once.  The result is the same as with a single thread
+ *     (the default).
+ *
  * Note that if both the option @em "leavePorts" and @em "listModelDefinitions"
  * are set to @c "false" (which they are by default), the Hierarchical %Model
  * Composition namespace will be removed from the resulting SBMLDocument.
@@ -475,6 +480,10 @@ writer.writeSBML(doc, args[1]);
  * <li> @em "performValidation": Possible values are @c "true" (the default)
  * or @c "false".  Controls whether whether libSBML validates the model
  * before attempting to flatten it.
+ *
+ * <li> @em "numThreads": The value must be a positive integer.  Controls
+ * how many threads are used to instantiate submodels.  (Default value:
+ * @c 1.)
  * </ul>
  */
 
@@ -639,6 +648,8 @@ private:
 
   bool getPerformValidation() const;
 
+  unsigned int getNumThreads() const;
+
   bool getAbortForAll() const;
 
   bool getAbortForRequired() const;
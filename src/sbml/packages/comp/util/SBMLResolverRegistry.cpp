@@ -40,6 +40,7 @@
 #include <sbml/packages/comp/util/SBMLResolverRegistry.h>
 #include <sbml/packages/comp/util/SBMLResolver.h>
 #include <sbml/packages/comp/util/SBMLFileResolver.h>
+#include <sbml/packages/comp/util/SBMLUri.h>
 #include <sbml/util/util.h>
 
 using namespace std;
@@ -121,6 +122,11 @@ SBMLResolverRegistry::getResolverByIndex(int index) const
 
 /** @cond doxygenLibsbmlInternal */
 SBMLResolverRegistry::SBMLResolverRegistry()
+  : mResolvers()
+  , mOwnedDocuments()
+  , mDocumentCaching(false)
+  , mDocumentCache()
+  , mDocumentCacheMutex()
 {
   // for now ensure that we always have a file resolver in there
   // 
@@ -144,6 +150,8 @@ SBMLResolverRegistry::~SBMLResolverRegistry()
   }
   mResolvers.clear();
 
+  clearDocumentCache();
+
   while(mOwnedDocuments.size())
   {
     const SBMLDocument* doc = *(mOwnedDocuments.begin());
@@ -155,18 +163,73 @@ SBMLResolverRegistry::~SBMLResolverRegistry()
 SBMLDocument*
 SBMLResolverRegistry::resolve(const std::string &uri, const std::string baseUri/*=""*/) const
 {
+  string key;
+  if (mDocumentCaching)
+  {
+    SBMLUri* resolved = resolveUri(uri, baseUri);
+    if (resolved != NULL)
+    {
+      key = resolved->getUri();
+      delete resolved;
+
+      MutexLock lock(mDocumentCacheMutex);
+      map<string, SBMLDocument*>::const_iterator cached = mDocumentCache.find(key);
+      if (cached != mDocumentCache.end())
+      {
+        return cached->second->clone();
+      }
+    }
+  }
+
   SBMLDocument* result = NULL;
   std::vector<const SBMLResolver*>::const_iterator it = mResolvers.begin();
   while(it != mResolvers.end())
   {
     result = (*it)->resolve(uri, baseUri);
     if (result != NULL)
-      return result;
+      break;
     ++it;
   }
+
+  if (result != NULL && !key.empty())
+  {
+    MutexLock lock(mDocumentCacheMutex);
+    if (mDocumentCache.find(key) == mDocumentCache.end())
+    {
+      mDocumentCache.insert(make_pair(key, result->clone()));
+    }
+  }
   return result;
 }
 
+void
+SBMLResolverRegistry::setDocumentCaching(bool cacheDocuments)
+{
+  mDocumentCaching = cacheDocuments;
+  if (!cacheDocuments)
+  {
+    clearDocumentCache();
+  }
+}
+
+bool
+SBMLResolverRegistry::getDocumentCaching() const
+{
+  return mDocumentCaching;
+}
+
+void
+SBMLResolverRegistry::clearDocumentCache()
+{
+  MutexLock lock(mDocumentCacheMutex);
+  for (map<string, SBMLDocument*>::iterator it = mDocumentCache.begin();
+       it != mDocumentCache.end(); ++it)
+  {
+    delete it->second;
+  }
+  mDocumentCache.clear();
+}
+
 SBMLUri* 
 SBMLResolverRegistry::resolveUri(const std::string &uri, const std::string baseUri/*=""*/) const
 {
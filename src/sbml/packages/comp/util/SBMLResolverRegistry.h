@@ -52,6 +52,7 @@
 
 #include <sbml/common/sbmlfwd.h>
 #include <sbml/packages/comp/util/SBMLResolver.h>
+#include <sbml/util/ThreadSupport.h>
 
 
 #ifdef __cplusplus
@@ -174,6 +175,39 @@ public:
    */
   virtual SBMLUri* resolveUri(const std::string &uri, const std::string baseUri="") const;
 
+  /**
+   * Sets whether the documents resolved are kept by the registry.
+   *
+   * Resolving a document normally reads it again every time.  When
+   * documents are kept, each one is read only once per process, and
+   * resolve() returns copies of the document read first.  This speeds up
+   * flattening many models that share the same external models, but
+   * changes made to the files afterwards are not seen until
+   * clearDocumentCache() is called.  Documents are not kept by default.
+   *
+   * @param cacheDocuments @c true to keep the documents resolved,
+   * @c false to read them every time (and discard those kept).
+   */
+  void setDocumentCaching(bool cacheDocuments);
+
+
+  /**
+   * Returns @c true if the documents resolved are kept by the registry.
+   *
+   * @return whether documents are kept.
+   *
+   * @see setDocumentCaching(@if java boolean@endif)
+   */
+  bool getDocumentCaching() const;
+
+
+  /**
+   * Discards the documents kept by the registry, so that they are read
+   * again the next time they are resolved.
+   */
+  void clearDocumentCache();
+
+
   /**
    * deletes the static resolver registry instance
    */
@@ -193,6 +227,9 @@ protected:
   /** @cond doxygenLibsbmlInternal */
   std::vector<const SBMLResolver*>  mResolvers;
   std::set<const SBMLDocument*>  mOwnedDocuments;
+  bool mDocumentCaching;
+  mutable std::map<std::string, SBMLDocument*> mDocumentCache;
+  mutable Mutex mDocumentCacheMutex;
   static SBMLResolverRegistry* mInstance;
   /** @endcond */
 };
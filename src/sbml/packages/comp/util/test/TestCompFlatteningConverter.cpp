@@ -2137,6 +2137,125 @@ START_TEST(test_comp_flatten_boundary_replace2)
 END_TEST
 
 
+/*
+ * Flattens the given document with the given number of threads, deletes
+ * it and returns the result code, the flattened document and the errors
+ * logged.
+ */
+static string
+flattenWithThreads(SBMLDocument* doc, int numThreads, int& result,
+                   string& errors)
+{
+  ConversionProperties props;
+  props.addOption("flatten comp");
+  props.addOption("basePath", string(TestDataDirectory));
+  props.addOption("performValidation", false);
+  props.addOption("numThreads", numThreads);
+
+  SBMLConverter* converter = 
+    SBMLConverterRegistry::getInstance().getConverterFor(props);
+
+  converter->setDocument(doc);
+  result = converter->convert();
+
+  errors.clear();
+  for (unsigned int e = 0; e < doc->getNumErrors(); e++)
+  {
+    errors += doc->getError(e)->getMessage();
+    errors += "\n";
+  }
+
+  string flat = writeSBMLToStdString(doc);
+
+  delete doc;
+  delete converter;
+
+  return flat;
+}
+
+
+static void
+TestFlattenedWithThreads(const string& file)
+{
+  string filename = string(TestDataDirectory) + file;
+  int serialResult, threadedResult;
+  string serialErrors, threadedErrors;
+
+  string serial = flattenWithThreads(readSBMLFromFile(filename.c_str()), 1,
+                                     serialResult, serialErrors);
+  string threaded = flattenWithThreads(readSBMLFromFile(filename.c_str()), 4,
+                                       threadedResult, threadedErrors);
+
+  fail_unless(threadedResult == serialResult);
+  fail_unless(threaded == serial);
+  fail_unless(threadedErrors == serialErrors);
+}
+
+
+START_TEST(test_comp_flatten_threads)
+{
+  const char* files[] = {
+    "aggregate.xml", "aggregate_fbc.xml", "CompTest.xml", 
+    "complexified.xml", "complexified2.xml", "doubleext.xml",
+    "doubleext2.xml", "eg-import-external.xml", "enzyme_identical.xml",
+    "fbc_v2_1_extmod_nofbcns.xml", "id_collisions.xml", "QTPop.xml",
+    "test13.xml", "test41.xml", "test62.xml",
+    "circular.xml", "flatten_fail1.xml", "flatten_fail2.xml"
+  };
+
+  for (size_t n = 0; n < sizeof(files) / sizeof(files[0]); n++)
+  {
+    TestFlattenedWithThreads(files[n]);
+  }
+}
+END_TEST
+
+
+START_TEST(test_comp_flatten_threads_packages)
+{
+  // instantiating 'ext' enables 'fbc' on the document, which changes the
+  // copy made of 'local' afterwards
+  const char* xml =
+    "<?xml version='1.0' encoding='UTF-8'?>"
+    "<sbml xmlns='http://www.sbml.org/sbml/level3/version1/core' "
+    "xmlns:comp='http://www.sbml.org/sbml/level3/version1/comp/version1' "
+    "level='3' version='1' comp:required='true'>"
+    "  <model>"
+    "    <comp:listOfSubmodels>"
+    "      <comp:submodel comp:id='ext' comp:modelRef='m'/>"
+    "      <comp:submodel comp:id='loc' comp:modelRef='local'/>"
+    "    </comp:listOfSubmodels>"
+    "  </model>"
+    "  <comp:listOfModelDefinitions>"
+    "    <comp:modelDefinition id='local'>"
+    "      <listOfCompartments>"
+    "        <compartment id='c' constant='true'/>"
+    "      </listOfCompartments>"
+    "    </comp:modelDefinition>"
+    "  </comp:listOfModelDefinitions>"
+    "  <comp:listOfExternalModelDefinitions>"
+    "    <comp:externalModelDefinition comp:id='m' "
+    "comp:source='fbc_v2_1.xml' comp:modelRef='m'/>"
+    "  </comp:listOfExternalModelDefinitions>"
+    "</sbml>";
+
+  int serialResult, threadedResult;
+  string serialErrors, threadedErrors;
+
+  string serial = flattenWithThreads(readSBMLFromString(xml), 1,
+                                     serialResult, serialErrors);
+  string threaded = flattenWithThreads(readSBMLFromString(xml), 4,
+                                       threadedResult, threadedErrors);
+
+  fail_unless(serialResult == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(serial.find("fbc:") != string::npos);
+  fail_unless(threadedResult == serialResult);
+  fail_unless(threaded == serial);
+  fail_unless(threadedErrors == serialErrors);
+}
+END_TEST
+
+
 Suite *
 create_suite_TestFlatteningConverter (void)
 { 
@@ -2279,6 +2398,8 @@ create_suite_TestFlatteningConverter (void)
   tcase_add_test(tcase, test_comp_flatten_test1_l3v2);
   tcase_add_test(tcase, test_comp_flatten_boundary_replace1);
   tcase_add_test(tcase, test_comp_flatten_boundary_replace2);
+  tcase_add_test(tcase, test_comp_flatten_threads);
+  tcase_add_test(tcase, test_comp_flatten_threads_packages);
 
   suite_add_tcase(suite, tcase);
 
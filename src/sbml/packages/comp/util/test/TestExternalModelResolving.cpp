@@ -32,10 +32,16 @@
 #include <sbml/packages/comp/extension/CompSBMLDocumentPlugin.h>
 #include <sbml/packages/comp/validator/CompSBMLErrorTable.h>
 #include <sbml/packages/comp/sbml/ExternalModelDefinition.h>
+#include <sbml/packages/comp/util/SBMLFileResolver.h>
+#include <sbml/packages/comp/util/SBMLResolverRegistry.h>
+#include <sbml/conversion/ConversionProperties.h>
 #include <sbml/SBMLReader.h>
+#include <sbml/SBMLWriter.h>
 
 #include <check.h>
 
+#include <map>
+
 using namespace std;
 
 LIBSBML_CPP_NAMESPACE_USE
@@ -110,6 +116,174 @@ START_TEST (test_comp_externalmodelresolving_files)
 END_TEST
 
 
+/*
+ * A file resolver counting the documents it reads.
+ */
+static map<string, int> resolvedCounts;
+
+class CountingResolver : public SBMLFileResolver
+{
+public:
+
+  virtual CountingResolver* clone() const
+  {
+    return new CountingResolver(*this);
+  }
+
+  virtual SBMLDocument* resolve(const std::string &uri,
+                                const std::string& baseUri="") const
+  {
+    SBMLDocument* doc = SBMLFileResolver::resolve(uri, baseUri);
+    if (doc != NULL)
+    {
+      ++resolvedCounts[uri];
+    }
+    return doc;
+  }
+};
+
+
+static const char* sharedSources =
+  "<?xml version='1.0' encoding='UTF-8'?>"
+  "<sbml xmlns='http://www.sbml.org/sbml/level3/version1/core' "
+  "xmlns:comp='http://www.sbml.org/sbml/level3/version1/comp/version1' "
+  "level='3' version='1' comp:required='true'>"
+  "  <model id='top'>"
+  "    <comp:listOfSubmodels>"
+  "      <comp:submodel comp:id='A' comp:modelRef='E1'/>"
+  "      <comp:submodel comp:id='B' comp:modelRef='E1'/>"
+  "      <comp:submodel comp:id='C' comp:modelRef='E2'/>"
+  "      <comp:submodel comp:id='D' comp:modelRef='E2'/>"
+  "      <comp:submodel comp:id='E' comp:modelRef='E3'/>"
+  "    </comp:listOfSubmodels>"
+  "  </model>"
+  "  <comp:listOfExternalModelDefinitions>"
+  "    <comp:externalModelDefinition comp:id='E1' "
+  "      comp:source='enzyme_model.xml' comp:modelRef='enzyme'/>"
+  "    <comp:externalModelDefinition comp:id='E2' "
+  "      comp:source='enzyme_identical.xml' comp:modelRef='ExtMod1'/>"
+  "    <comp:externalModelDefinition comp:id='E3' "
+  "      comp:source='enzyme_identical.xml'/>"
+  "  </comp:listOfExternalModelDefinitions>"
+  "</sbml>";
+
+
+static SBMLDocument*
+readSharedSources()
+{
+  SBMLDocument* doc = readSBMLFromString(sharedSources);
+  doc->setLocationURI("file:" + string(TestDataDirectory) + "shared.xml");
+  return doc;
+}
+
+
+static string
+flattenSharedSources()
+{
+  SBMLDocument* doc = readSharedSources();
+
+  ConversionProperties props;
+  props.addOption("flatten comp");
+  props.addOption("performValidation", false);
+  fail_unless(doc->convert(props) == LIBSBML_OPERATION_SUCCESS);
+
+  string flat = writeSBMLToStdString(doc);
+  delete doc;
+
+  return flat;
+}
+
+
+/*
+ * Replaces the file resolver of the registry by a counting one.
+ */
+static void
+useCountingResolver()
+{
+  SBMLResolverRegistry& registry = SBMLResolverRegistry::getInstance();
+  fail_unless(registry.getNumResolvers() == 1);
+  registry.removeResolver(0);
+
+  CountingResolver resolver;
+  registry.addResolver(&resolver);
+  resolvedCounts.clear();
+}
+
+
+static void
+useFileResolver()
+{
+  SBMLResolverRegistry& registry = SBMLResolverRegistry::getInstance();
+  registry.removeResolver(0);
+
+  SBMLFileResolver resolver;
+  registry.addResolver(&resolver);
+}
+
+
+START_TEST (test_comp_externalmodelresolving_shared)
+{
+  useCountingResolver();
+
+  SBMLDocument* doc = readSharedSources();
+  CompSBMLDocumentPlugin* compdoc = 
+    static_cast<CompSBMLDocumentPlugin*>(doc->getPlugin("comp"));
+
+  // the documents referred to by other documents are only read once too
+  Model* m1 = compdoc->getExternalModelDefinition("E1")->getReferencedModel();
+  Model* m2 = compdoc->getExternalModelDefinition("E2")->getReferencedModel();
+  fail_unless(m1 != NULL);
+  fail_unless(m1 == m2);
+  fail_unless(resolvedCounts["enzyme_model.xml"] == 1);
+  fail_unless(resolvedCounts["enzyme_identical.xml"] == 1);
+
+  ConversionProperties props;
+  props.addOption("flatten comp");
+  props.addOption("performValidation", false);
+  fail_unless(doc->convert(props) == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(resolvedCounts["enzyme_model.xml"] == 1);
+  fail_unless(resolvedCounts["enzyme_identical.xml"] == 1);
+  fail_unless(doc->getModel()->getNumSpecies() > 0);
+
+  delete doc;
+
+  useFileResolver();
+}
+END_TEST
+
+
+START_TEST (test_comp_externalmodelresolving_cache)
+{
+  useCountingResolver();
+  SBMLResolverRegistry& registry = SBMLResolverRegistry::getInstance();
+  fail_unless(registry.getDocumentCaching() == false);
+
+  string flat = flattenSharedSources();
+  flattenSharedSources();
+  fail_unless(resolvedCounts["enzyme_model.xml"] == 2);
+  fail_unless(resolvedCounts["enzyme_identical.xml"] == 2);
+
+  // with caching the sources are read once for all documents
+  resolvedCounts.clear();
+  registry.setDocumentCaching(true);
+  fail_unless(flattenSharedSources() == flat);
+  fail_unless(flattenSharedSources() == flat);
+  fail_unless(resolvedCounts["enzyme_model.xml"] == 1);
+  fail_unless(resolvedCounts["enzyme_identical.xml"] == 1);
+
+  registry.clearDocumentCache();
+  fail_unless(flattenSharedSources() == flat);
+  fail_unless(resolvedCounts["enzyme_model.xml"] == 2);
+
+  registry.setDocumentCaching(false);
+  fail_unless(flattenSharedSources() == flat);
+  fail_unless(resolvedCounts["enzyme_model.xml"] == 3);
+
+  useFileResolver();
+}
+END_TEST
+
+
 Suite *
 create_suite_TestExternalModelResolving (void)
 { 
@@ -118,6 +292,8 @@ create_suite_TestExternalModelResolving (void)
   
   tcase_add_test(tcase, test_comp_externalmodelresolving_);
   tcase_add_test(tcase, test_comp_externalmodelresolving_files);
+  tcase_add_test(tcase, test_comp_externalmodelresolving_shared);
+  tcase_add_test(tcase, test_comp_externalmodelresolving_cache);
   suite_add_tcase(suite, tcase);
 
   return suite;
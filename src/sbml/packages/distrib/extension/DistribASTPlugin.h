@@ -98,6 +98,7 @@ public:
 
 
   virtual bool hasCorrectNamespace(SBMLNamespaces* namespaces) const;
+  using ASTBasePlugin::evaluateASTNode;
   virtual double evaluateASTNode(const ASTNode * node, const Model * m = NULL) const;
   virtual UnitDefinition * getUnitDefinitionFromPackage(UnitFormulaFormatter* uff, const ASTNode * node, bool inKL, int reactNo) const;
 
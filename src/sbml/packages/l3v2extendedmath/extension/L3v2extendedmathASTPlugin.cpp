@@ -215,7 +215,32 @@ int L3v2extendedmathASTPlugin::checkNumArguments(const ASTNode* node, std::strin
   return -1;
 }
 
-double L3v2extendedmathASTPlugin::evaluateASTNode(const ASTNode * node, const Model * m) const
+/*
+ * The arguments of the functions are evaluated either with the values
+ * SBMLTransforms holds for a model or with those of an EvaluationContext.
+ */
+struct EvaluateWithModel
+{
+  EvaluateWithModel(const Model * m) : mModel(m) {}
+  double operator()(const ASTNode * node) const
+  {
+    return SBMLTransforms::evaluateASTNode(node, mModel);
+  }
+  const Model * mModel;
+};
+
+struct EvaluateWithContext
+{
+  EvaluateWithContext(const EvaluationContext& context) : mContext(context) {}
+  double operator()(const ASTNode * node) const
+  {
+    return mContext.evaluate(node);
+  }
+  const EvaluationContext& mContext;
+};
+
+template <typename Evaluate>
+static double evaluateExtendedMath(const ASTNode * node, const Evaluate& evaluate)
 {
   double result = numeric_limits<double>::quiet_NaN();
   switch(node->getType()) {
@@ -223,8 +248,8 @@ double L3v2extendedmathASTPlugin::evaluateASTNode(const ASTNode * node, const Mo
     if (node->getNumChildren() < 2) result = 0.0;
     else
     {
-      double dividend = SBMLTransforms::evaluateASTNode(node->getChild(0), m);
-      double divisor = SBMLTransforms::evaluateASTNode(node->getChild(1), m);
+      double dividend = evaluate(node->getChild(0));
+      double divisor = evaluate(node->getChild(1));
       double quotient = floor(dividend / divisor);
 
       result = dividend - (quotient * divisor);
@@ -232,19 +257,19 @@ double L3v2extendedmathASTPlugin::evaluateASTNode(const ASTNode * node, const Mo
     break;
 
   case AST_FUNCTION_MIN:
-    result = SBMLTransforms::evaluateASTNode(node->getChild(0), m);
+    result = evaluate(node->getChild(0));
     for (unsigned int j = 1; j < node->getNumChildren(); j++)
     {
-      double nextValue = SBMLTransforms::evaluateASTNode(node->getChild(j), m);
+      double nextValue = evaluate(node->getChild(j));
       if (nextValue < result) result = nextValue;
     }
     break;
 
   case AST_FUNCTION_MAX:
-    result = SBMLTransforms::evaluateASTNode(node->getChild(0), m);
+    result = evaluate(node->getChild(0));
     for (unsigned int j = 1; j < node->getNumChildren(); j++)
     {
-      double nextValue = SBMLTransforms::evaluateASTNode(node->getChild(j), m);
+      double nextValue = evaluate(node->getChild(j));
       if (nextValue > result) result = nextValue;
     }
     break;
@@ -254,10 +279,10 @@ double L3v2extendedmathASTPlugin::evaluateASTNode(const ASTNode * node, const Mo
     if (node->getNumChildren() == 0)
       result = 0.0;
     else if (node->getNumChildren() == 1)
-      result = SBMLTransforms::evaluateASTNode(node->getChild(0), m);
+      result = evaluate(node->getChild(0));
     else
-      result = (double)((!(SBMLTransforms::evaluateASTNode(node->getChild(0), m)))
-        || (SBMLTransforms::evaluateASTNode(node->getChild(1), m)));
+      result = (double)((!(evaluate(node->getChild(0))))
+        || (evaluate(node->getChild(1))));
   }
   break;
 
@@ -265,8 +290,8 @@ double L3v2extendedmathASTPlugin::evaluateASTNode(const ASTNode * node, const Mo
     if (node->getNumChildren() < 2) result = 0.0;
     else 
     {      
-      result = floor(SBMLTransforms::evaluateASTNode(node->getChild(0), m) /
-        SBMLTransforms::evaluateASTNode(node->getChild(1), m));
+      result = floor(evaluate(node->getChild(0)) /
+        evaluate(node->getChild(1)));
     }
     break;
 
@@ -279,6 +304,16 @@ double L3v2extendedmathASTPlugin::evaluateASTNode(const ASTNode * node, const Mo
   return result;
 }
 
+double L3v2extendedmathASTPlugin::evaluateASTNode(const ASTNode * node, const Model * m) const
+{
+  return evaluateExtendedMath(node, EvaluateWithModel(m));
+}
+
+double L3v2extendedmathASTPlugin::evaluateASTNode(const ASTNode * node, const EvaluationContext& context) const
+{
+  return evaluateExtendedMath(node, EvaluateWithContext(context));
+}
+
 /** 
 * returns the unitDefinition for the ASTNode from a rem function
 */
@@ -40,11 +40,15 @@
 #include <vector>
 #include <sstream>
 #include <iomanip>
+#include <cerrno>
+#include <climits>
+#include <clocale>
+#include <cmath>
 #include <sbml/compress/CompressCommon.h>
+#include <sbml/packages/spatial/common/CompressionUtil.h>
 
 #ifdef USE_ZLIB
 #include <zlib.h>
-#include "CompressionUtil.h"
 #endif
 
 using namespace std;
@@ -102,6 +106,117 @@ std::string charIntsToString(const int * array, size_t length)
   return ret;
 }
 
+/*
+ * Reads the number at the start of str (after any whitespace), the same
+ * way as operator>> would in the "C" locale.
+ */
+static bool
+readSample(const char*& str, double& value)
+{
+  char* end;
+  errno = 0;
+  value = strtod(str, &end);
+  if (end == str || (errno == ERANGE && fabs(value) == HUGE_VAL))
+  {
+    return false;
+  }
+  str = end;
+  return true;
+}
+
+
+static bool
+readSample(const char*& str, float& value)
+{
+  char* end;
+  errno = 0;
+  value = strtof(str, &end);
+  if (end == str || (errno == ERANGE && fabs(value) == HUGE_VALF))
+  {
+    return false;
+  }
+  str = end;
+  return true;
+}
+
+
+static bool
+readSample(const char*& str, int& value)
+{
+  char* end;
+  errno = 0;
+  long result = strtol(str, &end, 10);
+  if (end == str || errno == ERANGE || result > INT_MAX || result < INT_MIN)
+  {
+    return false;
+  }
+  value = (int)result;
+  str = end;
+  return true;
+}
+
+
+template<typename type> static bool
+readSamples(const char* str, std::vector<type>& valuesVector)
+{
+  type val;
+
+  while (readSample(str, val))
+  {
+    valuesVector.push_back(val);
+    if (*str == ',') {
+      ++str;
+    }
+    if (*str == ';') {
+      ++str;
+    }
+  }
+
+  while (isspace((unsigned char)*str)) {
+    ++str;
+  }
+  return *str == '\0';
+}
+
+
+/*
+ * strtod() and strtof() follow the decimal point of the current locale,
+ * which the numbers of SBML do not.
+ */
+static bool
+hasCDecimalPoint()
+{
+  const char* point = localeconv()->decimal_point;
+  return point != NULL && point[0] == '.' && point[1] == '\0';
+}
+
+
+bool parseSamples(const char* str, std::vector<double>& valuesVector)
+{
+  if (!hasCDecimalPoint())
+  {
+    return parseSamples<double>(str, valuesVector);
+  }
+  return readSamples(str, valuesVector);
+}
+
+
+bool parseSamples(const char* str, std::vector<float>& valuesVector)
+{
+  if (!hasCDecimalPoint())
+  {
+    return parseSamples<float>(str, valuesVector);
+  }
+  return readSamples(str, valuesVector);
+}
+
+
+bool parseSamples(const char* str, std::vector<int>& valuesVector)
+{
+  return readSamples(str, valuesVector);
+}
+
+
 void compress_data(void* data, size_t length, int level, unsigned char*& result, int& outLength)
 {
 #ifndef USE_ZLIB
@@ -312,6 +427,99 @@ void uncompress_data(void* data, size_t length, int*& result, size_t& outLength)
 }
 
 
+/*
+ * Returns the position after which the text can be cut without changing
+ * how the numbers before and after it are read, or std::string::npos.
+ */
+static size_t
+findSampleBoundary(const std::string& text)
+{
+  for (size_t n = text.size(); n > 0; --n)
+  {
+    char c = text[n - 1];
+    if (isspace((unsigned char)c) || c == ';')
+    {
+      return n;
+    }
+    // a ',' may still be followed by a ';'
+    if (c == ',' && n < text.size() && text[n] != ';')
+    {
+      return n;
+    }
+  }
+  return std::string::npos;
+}
+
+
+template<typename type> static void
+uncompressSamples(void* data, size_t length, std::vector<type>& values)
+{
+  values.clear();
+#ifdef USE_ZLIB
+  const size_t BUFSIZE = 128 * 1024;
+  Bytef temp_buffer[BUFSIZE];
+
+  z_stream strm;
+  strm.zalloc = 0;
+  strm.zfree = 0;
+  strm.opaque = 0;
+  strm.next_in = reinterpret_cast<Bytef*>(data);
+  strm.avail_in = length;
+
+  if (inflateInit(&strm) != Z_OK)
+  {
+    return;
+  }
+
+  // the numbers not read yet, as the inflated text may end within one
+  std::string pending;
+  bool valid = true;
+  int res = Z_OK;
+
+  while (res == Z_OK && valid)
+  {
+    strm.next_out = temp_buffer;
+    strm.avail_out = BUFSIZE;
+    res = inflate(&strm, Z_NO_FLUSH);
+    if (res != Z_OK && res != Z_STREAM_END)
+    {
+      // like uncompress_data, keep what could be inflated
+      break;
+    }
+
+    pending.append(reinterpret_cast<char*>(temp_buffer), 
+                   BUFSIZE - strm.avail_out);
+
+    size_t boundary = findSampleBoundary(pending);
+    if (boundary != std::string::npos)
+    {
+      pending[boundary - 1] = '\0';
+      valid = parseSamples(pending.c_str(), values);
+      pending.erase(0, boundary);
+    }
+  }
+  inflateEnd(&strm);
+
+  if (valid)
+  {
+    parseSamples(pending.c_str(), values);
+  }
+#endif
+}
+
+
+void uncompress_samples(void* data, size_t length, std::vector<double>& values)
+{
+  uncompressSamples(data, length, values);
+}
+
+
+void uncompress_samples(void* data, size_t length, std::vector<float>& values)
+{
+  uncompressSamples(data, length, values);
+}
+
+
 void
 copySampleArrays(double*& target, size_t& targetLength, double* source, size_t sourceLength)
 {
@@ -41,6 +41,7 @@
 
 #include <vector>
 #include <iostream>
+#include <sstream>
 #include <cstdlib>
 
 LIBSBML_CPP_NAMESPACE_BEGIN
@@ -60,9 +61,15 @@ template<typename type> std::string vectorToString(const std::vector< type >& ve
 }
 
 
-template<typename type> void readSamplesFromString(const std::string& str, std::vector<type>& valuesVector)
+/*
+ * Appends the numbers of the given text to the vector, stopping at the
+ * first entry that is not a number.  Entries are separated by whitespace
+ * and may be followed by a ',' and a ';'.
+ *
+ * @return true if the whole text was read.
+ */
+template<typename type> bool parseSamples(const char* str, std::vector<type>& valuesVector)
 {
-  valuesVector.clear();
   std::stringstream strStream(str);
   type val;
 
@@ -76,11 +83,29 @@ template<typename type> void readSamplesFromString(const std::string& str, std::
       strStream.get();
     }
   }
+
+  if (!strStream.eof())
+  {
+    strStream.clear();
+    strStream >> std::ws;
+  }
+  return strStream.eof();
+}
+
+/* the common types are read without a stream */
+extern bool parseSamples(const char* str, std::vector<double>& valuesVector);
+extern bool parseSamples(const char* str, std::vector<float>& valuesVector);
+extern bool parseSamples(const char* str, std::vector<int>& valuesVector);
+
+
+template<typename type> void readSamplesFromString(const std::string& str, std::vector<type>& valuesVector)
+{
+  valuesVector.clear();
+  parseSamples(str.c_str(), valuesVector);
 }
 
 template<typename type> type* readSamplesFromString(const std::string& str, size_t& length)
 {
-  std::stringstream strStream(str);
   std::vector< type> valuesVector;
 
   readSamplesFromString(str, valuesVector);
@@ -122,6 +147,13 @@ extern std::string charIntsToString(const int* array, size_t length);
 extern void compress_data(void* data, size_t length, int level, unsigned char*& result, int& outLength);
 extern void uncompress_data(void* data, size_t length, double*& result, size_t& outLength);
 extern void uncompress_data(void* data, size_t length, int*& result, size_t& outLength);
+
+/*
+ * Inflates the data and reads the numbers of the text it holds into the
+ * vector as they are inflated, without building the whole text.
+ */
+extern void uncompress_samples(void* data, size_t length, std::vector<double>& values);
+extern void uncompress_samples(void* data, size_t length, std::vector<float>& values);
 extern void copySampleArrays(double* &target, size_t& targetLength, double* source, size_t sourceLength);
 extern void copySampleArrays(int* &target, size_t& targetLength, int* source, size_t sourceLength);
 extern void copySampleArrays(int*& target, size_t& targetLength, unsigned char* source, size_t sourceLength);
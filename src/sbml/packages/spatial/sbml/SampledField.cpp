@@ -51,6 +51,27 @@ LIBSBML_CPP_NAMESPACE_BEGIN
 
 #ifdef __cplusplus
 
+/*
+ * Reads the numbers held by the deflated text, given as one int per byte.
+ */
+template<typename type> static void
+readCompressedSamples(const int* compressed, size_t length,
+                      std::vector<type>& values)
+{
+  values.clear();
+  if (compressed == NULL || length == 0)
+  {
+    return;
+  }
+
+  std::vector<char> csamples(length);
+  for (size_t i = 0; i < length; ++i)
+  {
+    csamples[i] = (char)compressed[i];
+  }
+  uncompress_samples(&csamples[0], length, values);
+}
+
 /*
  * Creates a new SampledField using the given SBML Level, Version and
  * &ldquo;spatial&rdquo; package version.
@@ -72,7 +93,7 @@ SampledField::SampledField(unsigned int level,
   , mSamplesLength(SBML_INT_MAX)
   , mIsSetSamplesLength(false)
   , mSamplesCompressed(NULL)
-  , mSamplesUncompressed(NULL)
+  , mSamplesUncompressed()
   , mSamplesUncompressedInt(NULL)
   , mSamplesCompressedLength(0)
   , mSamplesUncompressedLength(0)
@@ -100,7 +121,7 @@ SampledField::SampledField(SpatialPkgNamespaces* spatialns)
   , mSamplesLength(SBML_INT_MAX)
   , mIsSetSamplesLength(false)
   , mSamplesCompressed(NULL)
-  , mSamplesUncompressed(NULL)
+  , mSamplesUncompressed()
   , mSamplesUncompressedInt(NULL)
   , mSamplesCompressedLength(0)
   , mSamplesUncompressedLength(0)
@@ -131,7 +152,7 @@ SampledField::SampledField(const SampledField& orig)
   , mSamplesLength(orig.mSamplesLength)
   , mIsSetSamplesLength(orig.mIsSetSamplesLength)
   , mSamplesCompressed(NULL)
-  , mSamplesUncompressed(NULL)
+  , mSamplesUncompressed()
   , mSamplesUncompressedInt(NULL)
   , mSamplesCompressedLength(0)
   , mSamplesUncompressedLength(0)
@@ -314,18 +335,22 @@ void SampledField::getSamples(std::vector<int>& outVector) const
 
 void SampledField::getSamples(std::vector<float>& outVector) const
 {
-  store();
-  string uncompressedString;
-  uncompressInternal(uncompressedString, mSamplesUncompressedLength);
-  readSamplesFromString<float>(uncompressedString, outVector);
+  outVector.clear();
+  if (mCompression == SPATIAL_COMPRESSIONKIND_DEFLATED)
+  {
+    store();
+    readCompressedSamples(mSamplesCompressed, mSamplesCompressedLength,
+                          outVector);
+  }
+  else
+  {
+    readSamplesFromString<float>(mSamples, outVector);
+  }
 }
 
 void SampledField::getSamples(std::vector<double>& outVector) const
 {
-  store();
-  string uncompressedString;
-  uncompressInternal(uncompressedString, mSamplesUncompressedLength);
-  readSamplesFromString<double>(uncompressedString, outVector);
+  outVector = getUncompressedSamples();
 }
 
 std::string SampledField::getSamples() const
@@ -351,6 +376,16 @@ SampledField::getSamples(int* outArray) const
   }
   else
   {
+    if (mSamplesUncompressedInt == NULL && mSamplesUncompressedLength > 0)
+    {
+      size_t length;
+      mSamplesUncompressedInt = readSamplesFromString<int>(mSamples, length);
+      if (length != mSamplesUncompressedLength)
+      {
+        free(mSamplesUncompressedInt);
+        mSamplesUncompressedInt = NULL;
+      }
+    }
     if (mSamplesUncompressedInt == NULL)
     {
       return LIBSBML_OPERATION_FAILED;
@@ -367,15 +402,14 @@ SampledField::getSamples(double* outArray) const
   {
     return LIBSBML_OPERATION_FAILED;
   }
-  //This function will uncompres and store the data if need be:
-  size_t len = getUncompressedLength();
 
-  if (mSamplesUncompressed == NULL)
+  const std::vector<double>& samples = getUncompressedSamples();
+  if (samples.empty())
   {
     return LIBSBML_OPERATION_FAILED;
   }
 
-  memcpy(outArray, mSamplesUncompressed, sizeof(double)*mSamplesUncompressedLength);
+  memcpy(outArray, &samples[0], sizeof(double)*samples.size());
   return LIBSBML_OPERATION_SUCCESS;
 }
 
@@ -388,28 +422,23 @@ SampledField::getSamples(float* outArray) const
     return LIBSBML_OPERATION_FAILED;
   }
 
-  store();
-  float* samples = NULL;
-  size_t length;
-  if (mCompression == SPATIAL_COMPRESSIONKIND_DEFLATED)
-  {
-    string uncompressedString;
-    uncompressInternal(uncompressedString, length);
-    samples = readSamplesFromString<float>(uncompressedString, length);
-  }
-  else {
-    samples = readSamplesFromString<float>(mSamples, length);
-  }
-
-  if (samples == NULL || length==0)
+  std::vector<float> samples;
+  getSamples(samples);
+  if (samples.empty())
   {
     return LIBSBML_OPERATION_FAILED;
   }
-  memcpy(outArray, samples, sizeof(float) * length);
-  free(samples);
+  memcpy(outArray, &samples[0], sizeof(float) * samples.size());
   return LIBSBML_OPERATION_SUCCESS;
 }
 
+const std::vector<double>&
+SampledField::getUncompressedSamples() const
+{
+  decodeSamples();
+  return mSamplesUncompressed;
+}
+
 int
 SampledField::getSamplesLength() const
 {
@@ -678,6 +707,12 @@ SampledField::setInterpolationType(const std::string& interpolationType)
 int
 SampledField::setCompression(const CompressionKind_t compression)
 {
+  // the samples now mean something else
+  if (compression != mCompression)
+  {
+    freeCompressed();
+    freeUncompressed();
+  }
   if (CompressionKind_isValid(compression) == 0)
   {
     mCompression = SPATIAL_COMPRESSIONKIND_INVALID;
@@ -697,6 +732,11 @@ SampledField::setCompression(const CompressionKind_t compression)
 int
 SampledField::setCompression(const std::string& compression)
 {
+  if (CompressionKind_fromString(compression.c_str()) != mCompression)
+  {
+    freeCompressed();
+    freeUncompressed();
+  }
   if (CompressionKind_isValidString(compression.c_str()) == 0)
   {
     mCompression = SPATIAL_COMPRESSIONKIND_INVALID;
@@ -728,7 +768,8 @@ SampledField::setSamples(double* inArray, size_t arrayLength)
 
   freeCompressed();
   freeUncompressed();
-  copySampleArrays(mSamplesUncompressed, mSamplesUncompressedLength, inArray, arrayLength);
+  mSamplesUncompressed.assign(inArray, inArray + arrayLength);
+  mSamplesUncompressedLength = arrayLength;
   mSamples = arrayToString(inArray, arrayLength);
   return setSamplesLength(arrayLength);
 }
@@ -766,6 +807,8 @@ int SampledField::setSamples(unsigned int* inArray, size_t arrayLength)
     return LIBSBML_INVALID_ATTRIBUTE_VALUE;
   }
 
+  freeCompressed();
+  freeUncompressed();
   mSamples = arrayToString(inArray, arrayLength);
 
   return setSamplesLength(arrayLength);
@@ -778,6 +821,8 @@ int SampledField::setSamples(unsigned char* inArray, size_t arrayLength)
     return LIBSBML_INVALID_ATTRIBUTE_VALUE;
   }
 
+  freeCompressed();
+  freeUncompressed();
   mSamples = arrayToString(inArray, arrayLength);
 
   return setSamplesLength(arrayLength);
@@ -793,6 +838,8 @@ SampledField::setSamples(float* inArray, size_t arrayLength)
   }
   setCompression(SPATIAL_COMPRESSIONKIND_UNCOMPRESSED);
 
+  freeCompressed();
+  freeUncompressed();
   mSamples = arrayToString(inArray, arrayLength);
 
   return setSamplesLength(arrayLength);
@@ -800,27 +847,37 @@ SampledField::setSamples(float* inArray, size_t arrayLength)
 
 int SampledField::setSamples(const std::string& samples)
 {
+  freeCompressed();
+  freeUncompressed();
   mSamples = samples;
   return LIBSBML_OPERATION_SUCCESS;
 }
 
 int SampledField::setSamples(const std::vector<double>& samples)
 {
-  mSamples = vectorToString(samples);
   setCompression(SPATIAL_COMPRESSIONKIND_UNCOMPRESSED);
+  freeCompressed();
+  freeUncompressed();
+  mSamplesUncompressed = samples;
+  mSamplesUncompressedLength = samples.size();
+  mSamples = vectorToString(samples);
   return setSamplesLength(samples.size());
 }
 
 int SampledField::setSamples(const std::vector<int>& samples)
 {
+  freeCompressed();
+  freeUncompressed();
   mSamples = vectorToString(samples);
   return setSamplesLength(samples.size());
 }
 
 int SampledField::setSamples(const std::vector<float>& samples)
 {
-  mSamples = vectorToString(samples);
   setCompression(SPATIAL_COMPRESSIONKIND_UNCOMPRESSED);
+  freeCompressed();
+  freeUncompressed();
+  mSamples = vectorToString(samples);
   return setSamplesLength(samples.size());
 }
 
@@ -1991,25 +2048,18 @@ SampledField::writeAttributes(XMLOutputStream& stream) const
 void
 SampledField::setElementText(const std::string& text)
 {
+  freeCompressed();
+  freeUncompressed();
   mSamples = text;
   SBMLErrorLog* log = getErrorLog();
   if (log)
   {
     if (mCompression == SPATIAL_COMPRESSIONKIND_UNCOMPRESSED)
     {
-      stringstream strStream(text);
-      double val;
-
-      while (strStream >> val)
-      {
-        if (strStream.peek() == ',') {
-          strStream.get();
-        }
-        if (strStream.peek() == ';') {
-          strStream.get();
-        }
-      }
-      if (strStream.fail() && !strStream.eof())
+      // checking the values decodes them, so keep them
+      bool numeric = parseSamples(text.c_str(), mSamplesUncompressed);
+      mSamplesUncompressedLength = mSamplesUncompressed.size();
+      if (!numeric)
       {
         stringstream ss_msg;
         ss_msg << "A <SampledField>";
@@ -2062,23 +2112,32 @@ void SampledField::store() const
   }
   else
   {
-    if (mSamplesUncompressed == NULL) {
-      mSamplesUncompressed = readSamplesFromString<double>(mSamples, mSamplesUncompressedLength);
-      size_t alt_length;
-      free(mSamplesUncompressedInt);
-      mSamplesUncompressedInt = readSamplesFromString<int>(mSamples, alt_length);
-      if (alt_length != mSamplesUncompressedLength)
-      {
-        free(mSamplesUncompressedInt);
-        mSamplesUncompressedInt = NULL;
-      }
-    }
+    decodeSamples();
   }
 }
 
+void SampledField::decodeSamples() const
+{
+  if (!mSamplesUncompressed.empty())
+  {
+    return;
+  }
+
+  if (mCompression == SPATIAL_COMPRESSIONKIND_DEFLATED)
+  {
+    store();
+    readCompressedSamples(mSamplesCompressed, mSamplesCompressedLength,
+                          mSamplesUncompressed);
+  }
+  else
+  {
+    readSamplesFromString<double>(mSamples, mSamplesUncompressed);
+  }
+  mSamplesUncompressedLength = mSamplesUncompressed.size();
+}
+
 void SampledField::uncompressInternal(string& sampleString, size_t& length) const
 {
-  freeUncompressed();
   store();
 
   if (mCompression == SPATIAL_COMPRESSIONKIND_DEFLATED)
@@ -2127,13 +2186,14 @@ void SampledField::uncompressInternal(string& sampleString, size_t& length) cons
 void
 SampledField::getUncompressedData(double*& data, size_t& length)
 {
-  store();
-  length = getUncompressedLength();
+  const std::vector<double>& samples = getUncompressedSamples();
+  length = samples.size();
   if (length == 0)
   {
     return;
   }
-  copySampleArrays(data, length, mSamplesUncompressed, mSamplesUncompressedLength);
+  data = (double*)malloc(sizeof(double) * length);
+  memcpy(data, &samples[0], sizeof(double) * length);
   return;
 }
 
@@ -2142,18 +2202,26 @@ SampledField::uncompress()
 {
   if (mCompression == SPATIAL_COMPRESSIONKIND_DEFLATED)
   {
-    uncompressInternal(mSamples, mSamplesUncompressedLength);
+    // the decoded values stay valid, only their text changes
+    decodeSamples();
+    size_t length;
+    uncompressInternal(mSamples, length);
     mCompression = SPATIAL_COMPRESSIONKIND_UNCOMPRESSED;
-    store();
+    freeCompressed();
     setSamplesLength(mSamplesUncompressedLength);
   }
+  else
+  {
+    mCompression = SPATIAL_COMPRESSIONKIND_UNCOMPRESSED;
+  }
 
-  return setCompression(SPATIAL_COMPRESSIONKIND_UNCOMPRESSED);
+  return LIBSBML_OPERATION_SUCCESS;
 }
 
 int SampledField::compress(int level)
 {
   freeCompressed();
+  freeUncompressed();
   unsigned char* result; int length;
   compress_data(const_cast<char*>(mSamples.c_str()), mSamples.length(), level, result, length);
 
@@ -2163,33 +2231,23 @@ int SampledField::compress(int level)
   free(result);
 
   setSamplesLength(mSamplesCompressedLength);
-  return setCompression(SPATIAL_COMPRESSIONKIND_DEFLATED);
+  mCompression = SPATIAL_COMPRESSIONKIND_DEFLATED;
+  return LIBSBML_OPERATION_SUCCESS;
 }
 
 unsigned int
 SampledField::getUncompressedLength() const
 {
-  store();
-  if (mSamplesUncompressed == NULL) {
-    string uncompressedString;
-    uncompressInternal(uncompressedString, mSamplesUncompressedLength);
-    mSamplesUncompressed = readSamplesFromString<double>(uncompressedString, mSamplesUncompressedLength);
-  }
-  return mSamplesUncompressedLength;
+  return (unsigned int)getUncompressedSamples().size();
 }
 
 void
 SampledField::getUncompressed(double* outputPoints) const
 {
-  store();
   if (outputPoints == NULL) return;
-  if (mSamplesUncompressed == NULL) {
-    string uncompressedString;
-    uncompressInternal(uncompressedString, mSamplesUncompressedLength);
-    mSamplesUncompressed = readSamplesFromString<double>(uncompressedString, mSamplesUncompressedLength);
-  }
-  if (mSamplesUncompressed == NULL) return;
-  memcpy(outputPoints, mSamplesUncompressed, sizeof(double) * mSamplesUncompressedLength);
+  const std::vector<double>& samples = getUncompressedSamples();
+  if (samples.empty()) return;
+  memcpy(outputPoints, &samples[0], sizeof(double) * samples.size());
 }
 
 void
@@ -2197,11 +2255,8 @@ SampledField::freeUncompressed() const
 {
   free(mSamplesUncompressedInt);
   mSamplesUncompressedInt = NULL;
-  if (mSamplesUncompressed != NULL)
-  {
-    free(mSamplesUncompressed);
-  }
-  mSamplesUncompressed = NULL;
+  // swapping releases the memory, which clear() would not
+  std::vector<double>().swap(mSamplesUncompressed);
   mSamplesUncompressedLength = 0;
 }
 
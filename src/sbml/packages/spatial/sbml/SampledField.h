@@ -149,7 +149,7 @@ protected:
   bool mIsSetSamplesLength;
 
   mutable int* mSamplesCompressed;
-  mutable double* mSamplesUncompressed;
+  mutable std::vector<double> mSamplesUncompressed;
   mutable int* mSamplesUncompressedInt;
   mutable size_t mSamplesCompressedLength;
   mutable size_t mSamplesUncompressedLength;
@@ -461,6 +461,20 @@ public:
   */
   void getSamples(std::vector<float>& outVector) const;
 
+  /**
+   * Returns the uncompressed values of the samples entries of this
+   * SampledField, without copying them.
+   *
+   * The samples are decoded the first time they are needed only; deflated
+   * samples are read as they are inflated.  The vector returned belongs to
+   * this SampledField and stays valid until its samples or compression
+   * are changed.
+   *
+   * @return the uncompressed values of the samples entries of this
+   * SampledField, or an empty vector if they cannot be decoded.
+   */
+  const std::vector<double>& getUncompressedSamples() const;
+
   /**
    * Returns the value of the "samplesLength" attribute of this SampledField.
    *
@@ -1417,6 +1431,9 @@ protected:
   /* Store the ArrayData string as ints, either compressed or not.*/
   void store() const;
 
+  /* Decode the samples into mSamplesUncompressed unless they already are.*/
+  void decodeSamples() const;
+
   /* Uncompress the data, but don't store the change.*/
   void uncompressInternal(std::string & sampleString, size_t & length) const;
 
@@ -37,6 +37,7 @@
 #include <limits>
 
 #include <iostream>
+#include <sstream>
 #include <check.h>
 #include <sbml/common/extern.h>
 #include <sbml/packages/spatial/common/SpatialExtensionTypes.h>
@@ -348,6 +349,96 @@ START_TEST(test_Compression_SampledField_5)
 END_TEST
 
 
+START_TEST(test_Compression_SampledField_6)
+{
+  //This test checks that the samples are decoded once, until they change.
+
+  std::vector<double> values =
+  {
+    1.0, 2.0, 3.0, 4.0, 5.0, 6.0,
+    1.1, 2.1, 3.1, 4.1, 5.1, 6.1,
+    1.2, 2.2, 3.2, 4.2, 5.2, 6.2,
+    1.3, 2.3, 3.3, 4.3, 5.3, 6.3 };
+
+  std::vector<int> compressedvals =
+  { 120, 218, 101, 206, 185, 17, 0, 33, 12, 67, 209, 86, 84, 129, 7, 249, 154, 165, 255, 198, 128, 208, 43, 133, 47, 240, 55, 225, 8, 36, 10, 13, 26, 215, 24, 225, 74, 161, 148, 182, 246, 88, 163, 148, 90, 137, 230, 55, 225, 243, 222, 125, 72, 41, 149, 74, 169, 149, 104, 241, 18, 179, 252, 189, 196, 159, 82, 169, 148, 90, 233, 0, 141, 250, 63, 196 };
+
+  SampledField field;
+  field.setCompression(SPATIAL_COMPRESSIONKIND_DEFLATED);
+  field.setSamples(compressedvals);
+
+  const std::vector<double>& samples = field.getUncompressedSamples();
+  fail_unless(samples == values);
+  fail_unless(field.getUncompressedLength() == values.size());
+
+  const double* data = &samples[0];
+  vector<double> doublevec;
+  field.getSamples(doublevec);
+  fail_unless(doublevec == values);
+  fail_unless(&field.getUncompressedSamples()[0] == data);
+
+  // uncompressing changes the text, not the values
+  field.uncompress();
+  fail_unless(field.getCompression() == SPATIAL_COMPRESSIONKIND_UNCOMPRESSED);
+  fail_unless(&field.getUncompressedSamples()[0] == data);
+  fail_unless(field.getSamplesLength() == 24);
+
+  std::vector<double> others(3, 1.5);
+  field.setSamples(others);
+  fail_unless(field.getUncompressedSamples() == others);
+
+  field.setSamples("2 3");
+  fail_unless(field.getUncompressedSamples().size() == 2);
+  fail_unless(field.getUncompressedSamples()[1] == 3);
+
+  field.unsetSamples();
+  fail_unless(field.getUncompressedSamples().empty());
+}
+END_TEST
+
+
+START_TEST(test_Compression_SampledField_7)
+{
+  //This test checks samples whose inflated text spans several buffers.
+
+  std::stringstream text;
+  std::vector<double> values;
+  for (int n = 0; n < 60000; n++)
+  {
+    values.push_back(n + 0.25);
+    text << n << ".25";
+    switch (n % 3)
+    {
+    case 0: text << ",;"; break;
+    case 1: text << ", "; break;
+    default: text << " "; break;
+    }
+  }
+  fail_unless(text.str().size() > 4 * 128 * 1024);
+
+  SampledField field;
+  field.setCompression(SPATIAL_COMPRESSIONKIND_UNCOMPRESSED);
+  field.setSamples(text.str());
+  fail_unless(field.getUncompressedSamples() == values);
+
+  field.compress(9);
+  fail_unless(field.getCompression() == SPATIAL_COMPRESSIONKIND_DEFLATED);
+  fail_unless(field.getUncompressedSamples() == values);
+
+  std::vector<float> floatvec;
+  field.getSamples(floatvec);
+  fail_unless(floatvec.size() == values.size());
+  fail_unless(floatvec[59999] == 59999.25f);
+
+  // reading stops at the first entry that is not a number
+  field.setCompression(SPATIAL_COMPRESSIONKIND_UNCOMPRESSED);
+  field.setSamples(text.str() + "x 1 2");
+  field.compress(9);
+  fail_unless(field.getUncompressedSamples() == values);
+}
+END_TEST
+
+
 START_TEST(test_Compression_SpatialPoints_1)
 {
   // assume we have some values from our app in a structure
@@ -804,6 +895,8 @@ create_suite_Compression(void)
   tcase_add_test( tcase, test_Compression_SampledField_3);
   tcase_add_test( tcase, test_Compression_SampledField_4);
   tcase_add_test( tcase, test_Compression_SampledField_5);
+  tcase_add_test( tcase, test_Compression_SampledField_6);
+  tcase_add_test( tcase, test_Compression_SampledField_7);
   tcase_add_test( tcase, test_Compression_SpatialPoints_1);
   tcase_add_test( tcase, test_Compression_SpatialPoints_2);
   tcase_add_test( tcase, test_Compression_SpatialPoints_3);
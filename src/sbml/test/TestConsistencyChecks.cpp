@@ -117,6 +117,85 @@ START_TEST (test_consistency_checks)
 END_TEST
 
 
+/*
+ * Checks that the documents get the same errors, in the same order.
+ */
+static bool
+haveSameErrors (SBMLDocument* d1, SBMLDocument* d2)
+{
+  if (d1->getNumErrors() != d2->getNumErrors())
+  {
+    return false;
+  }
+
+  for (unsigned int n = 0; n < d1->getNumErrors(); ++n)
+  {
+    const SBMLError* e1 = d1->getError(n);
+    const SBMLError* e2 = d2->getError(n);
+    if (e1->getErrorId() != e2->getErrorId()
+      || e1->getSeverity() != e2->getSeverity()
+      || e1->getLine() != e2->getLine()
+      || e1->getColumn() != e2->getColumn()
+      || e1->getMessage() != e2->getMessage())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+START_TEST (test_consistency_checks_threads)
+{
+  const char* files[] = {
+    "inconsistent.xml", "inconsistent-l2v1-units.xml", "l2v4-new.xml",
+    "l3v2-all.xml", "l3v1-new-invalid.xml", "assignments-invalid.xml",
+    "multiple-ids.xml", NULL
+  };
+  const SBMLErrorCategory_t categories[] = {
+    LIBSBML_CAT_IDENTIFIER_CONSISTENCY, LIBSBML_CAT_GENERAL_CONSISTENCY,
+    LIBSBML_CAT_SBO_CONSISTENCY
+  };
+
+  for (unsigned int i = 0; files[i] != NULL; ++i)
+  {
+    std::string filename(TestDataDirectory);
+    filename += files[i];
+
+    SBMLDocument* d1 = readSBMLFromFile(filename.c_str());
+    SBMLDocument* d2 = readSBMLFromFile(filename.c_str());
+    fail_unless(d1 != NULL && d2 != NULL);
+
+    fail_unless(d2->getNumValidationThreads() == 1);
+    d2->setNumValidationThreads(4);
+    fail_unless(d2->getNumValidationThreads() == 4);
+
+    // switch off one category after the other, as above (but keep the
+    // MathML checks, which protect the unit checks from invalid math)
+    for (unsigned int c = 0; c <= 3; ++c)
+    {
+      d1->getErrorLog()->clearLog();
+      d2->getErrorLog()->clearLog();
+      if (c > 0)
+      {
+        d1->setConsistencyChecks(categories[c - 1], false);
+        d2->setConsistencyChecks(categories[c - 1], false);
+      }
+
+      fail_unless(d1->checkConsistency() == d2->checkConsistency());
+      fail_unless(haveSameErrors(d1, d2));
+    }
+
+    SBMLDocument copy(*d2);
+    fail_unless(copy.getNumValidationThreads() == 4);
+
+    delete d1;
+    delete d2;
+  }
+}
+END_TEST
+
+
 START_TEST (test_strict_unit_consistency_checks)
 {
   SBMLReader        reader;
@@ -159,6 +238,7 @@ create_suite_TestConsistencyChecks (void)
 
   tcase_add_test(tcase, test_consistency_checks);
   tcase_add_test(tcase, test_strict_unit_consistency_checks);
+  tcase_add_test(tcase, test_consistency_checks_threads);
 
   suite_add_tcase(suite, tcase);
 
@@ -0,0 +1,454 @@
+/**
+ * @file    TestListOfIdIndex.cpp
+ * @brief   Unit tests for the identifier index of ListOf
+ * @author  SBMLTeam
+ * 
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sbml/common/common.h>
+#include <sbml/common/extern.h>
+#include <sbml/SBMLTypes.h>
+#include <sbml/util/ThreadSupport.h>
+
+#include <check.h>
+
+#include <sstream>
+
+#ifdef LIBSBML_HAVE_THREADS
+#include <thread>
+#include <vector>
+#endif
+
+LIBSBML_CPP_NAMESPACE_USE
+
+BEGIN_C_DECLS
+
+
+static SBMLDocument* D;
+static Model*        M;
+
+
+void
+ListOfIdIndexTest_setup (void)
+{
+  D = new SBMLDocument(3, 1);
+  M = D->createModel();
+
+  for (unsigned int n = 0; n < 10; ++n)
+  {
+    std::ostringstream id;
+    id << "s" << n;
+    M->createSpecies()->setId(id.str());
+  }
+}
+
+
+void
+ListOfIdIndexTest_teardown (void)
+{
+  delete D;
+}
+
+
+START_TEST (test_ListOfIdIndex_get)
+{
+  fail_unless( M->getSpecies("s0") == M->getSpecies(0) );
+  fail_unless( M->getSpecies("s9") == M->getSpecies(9) );
+  fail_unless( M->getSpecies("s10") == NULL );
+  fail_unless( M->getSpecies("") == NULL );
+
+  /* items appended after the index was built */
+  Species* s = M->createSpecies();
+  fail_unless( M->getSpecies("s10") == NULL );
+
+  s->setId("s10");
+  fail_unless( M->getSpecies("s10") == s );
+
+  Species other(3, 1);
+  other.setId("s11");
+  M->addSpecies(&other);
+  fail_unless( M->getSpecies("s11") == M->getSpecies(11) );
+  fail_unless( M->getSpecies("s11") != &other );
+}
+END_TEST
+
+
+START_TEST (test_ListOfIdIndex_setId)
+{
+  Species* s = M->getSpecies("s3");
+
+  fail_unless( s->setId("x") == LIBSBML_OPERATION_SUCCESS );
+  fail_unless( M->getSpecies("s3") == NULL );
+  fail_unless( M->getSpecies("x") == s );
+
+  s->unsetIdAttribute();
+  fail_unless( M->getSpecies("x") == NULL );
+
+  s->setId("s3");
+  fail_unless( M->getSpecies("s3") == s );
+}
+END_TEST
+
+
+START_TEST (test_ListOfIdIndex_duplicates)
+{
+  Species* first  = M->getSpecies(2);
+  Species* second = M->getSpecies(7);
+
+  second->setId("s2");
+  fail_unless( M->getSpecies("s2") == first );
+  fail_unless( M->getSpecies("s7") == NULL );
+
+  /* renaming the first one exposes the second one */
+  first->setId("y");
+  fail_unless( M->getSpecies("s2") == second );
+
+  /* and taking the id back makes the first one win again */
+  first->setId("s2");
+  fail_unless( M->getSpecies("s2") == first );
+
+  delete M->removeSpecies("s2");
+  fail_unless( M->getSpecies("s2") == second );
+  fail_unless( M->getNumSpecies() == 9 );
+}
+END_TEST
+
+
+START_TEST (test_ListOfIdIndex_remove)
+{
+  fail_unless( M->getSpecies("s5") != NULL );
+
+  Species* s = M->removeSpecies(5);
+  fail_unless( s->getId() == "s5" );
+  fail_unless( M->getSpecies("s5") == NULL );
+  fail_unless( M->getSpecies("s6") == M->getSpecies(5) );
+
+  fail_unless( M->getListOfSpecies()->insertAndOwn(0, s)
+               == LIBSBML_OPERATION_SUCCESS );
+  fail_unless( M->getSpecies("s5") == M->getSpecies(0) );
+
+  s = M->removeSpecies("s5");
+  fail_unless( s != NULL );
+  fail_unless( M->getSpecies("s5") == NULL );
+  fail_unless( s->getParentSBMLObject() == NULL );
+
+  // renaming a removed item must not make it visible in the list again
+  s->setId("removed");
+  fail_unless( M->getSpecies("removed") == NULL );
+  delete s;
+  fail_unless( M->getSpecies("removed") == NULL );
+
+  fail_unless( M->removeSpecies("s5") == NULL );
+
+  M->getListOfSpecies()->clear();
+  fail_unless( M->getSpecies("s0") == NULL );
+  M->createSpecies()->setId("s0");
+  fail_unless( M->getSpecies("s0") == M->getSpecies(0) );
+}
+END_TEST
+
+
+START_TEST (test_ListOfIdIndex_removeOutlivesList)
+{
+  Species* s = M->removeSpecies("s1");
+  fail_unless( s != NULL );
+
+  delete D;
+  D = NULL;
+
+  fail_unless( s->setId("z") == LIBSBML_OPERATION_SUCCESS );
+  fail_unless( s->getId() == "z" );
+
+  // the namespaces of the document are kept
+  fail_unless( s->getSBMLNamespaces()->getNamespaces() != NULL );
+  fail_unless( s->getNamespaces()->getNumNamespaces() > 0 );
+  delete s;
+}
+END_TEST
+
+
+/* a subclass changing the items without going through ListOf */
+class ListOfSpeciesEraser : public ListOfSpecies
+{
+public:
+  ListOfSpeciesEraser() : ListOfSpecies(3, 1) {}
+
+  Species* append(const std::string& id)
+  {
+    Species* s = new Species(3, 1);
+    s->setId(id);
+    appendAndOwn(s);
+    return s;
+  }
+
+  SBase* eraseFirst()
+  {
+    SBase* item = mItems.front();
+    mItems.erase(mItems.begin());
+    return item;
+  }
+};
+
+
+START_TEST (test_ListOfIdIndex_directChanges)
+{
+  ListOfSpeciesEraser list;
+  for (unsigned int n = 0; n < 3; ++n)
+  {
+    std::ostringstream id;
+    id << "e" << n;
+    list.append(id.str());
+  }
+  fail_unless( list.get("e0") == list.get(0) );
+
+  /* same size as before, but not the same items */
+  SBase* erased = list.eraseFirst();
+  Species* s = list.append("e3");
+
+  fail_unless( list.size() == 3 );
+  fail_unless( list.get("e0") == NULL );
+  fail_unless( list.get("e3") == s );
+  fail_unless( erased->getParentSBMLObject() == NULL );
+  delete erased;
+}
+END_TEST
+
+
+START_TEST (test_ListOfIdIndex_read)
+{
+  const char* s =
+    "<?xml version='1.0' encoding='UTF-8'?>\n"
+    "<sbml xmlns='http://www.sbml.org/sbml/level3/version1/core' "
+    "level='3' version='1'>\n"
+    "  <model>\n"
+    "    <listOfCompartments>\n"
+    "      <compartment id='c' constant='true'/>\n"
+    "    </listOfCompartments>\n"
+    "    <listOfSpecies>\n"
+    "      <species id='a' compartment='c' hasOnlySubstanceUnits='false'"
+    " boundaryCondition='false' constant='false'/>\n"
+    "      <species id='b' compartment='c' hasOnlySubstanceUnits='false'"
+    " boundaryCondition='false' constant='false'/>\n"
+    "    </listOfSpecies>\n"
+    "  </model>\n"
+    "</sbml>\n";
+
+  SBMLDocument* d = readSBMLFromString(s);
+  const Model*  m = d->getModel();
+
+  fail_unless( m->getSpecies("a") == m->getSpecies(0) );
+  fail_unless( m->getSpecies("b") == m->getSpecies(1) );
+  fail_unless( m->getCompartment("c") == m->getCompartment(0) );
+  fail_unless( d->getModel()->getElementBySId("b") == m->getSpecies(1) );
+
+  delete d;
+}
+END_TEST
+
+
+START_TEST (test_ListOfIdIndex_assign)
+{
+  fail_unless( M->getSpecies("s4") != NULL );
+
+  Species replacement(3, 1);
+  replacement.setId("z");
+  *(M->getSpecies(4)) = replacement;
+
+  fail_unless( M->getSpecies("s4") == NULL );
+  fail_unless( M->getSpecies("z") == M->getSpecies(4) );
+
+  /* copies carry their own index */
+  ListOfSpecies* copy = M->getListOfSpecies()->clone();
+  fail_unless( copy->get("z") == copy->get(4) );
+  copy->get(4)->setId("w");
+  fail_unless( copy->get("w") == copy->get(4) );
+  fail_unless( M->getSpecies("z") == M->getSpecies(4) );
+  delete copy;
+}
+END_TEST
+
+
+START_TEST (test_ListOfIdIndex_getElementBySId)
+{
+  Reaction* r = M->createReaction();
+  r->setId("J0");
+  LocalParameter* lp = r->createKineticLaw()->createLocalParameter();
+  lp->setId("k");
+  UnitDefinition* ud = M->createUnitDefinition();
+  ud->setId("u");
+
+  fail_unless( M->getElementBySId("s1") == M->getSpecies(1) );
+  fail_unless( M->getElementBySId("J0") == r );
+  fail_unless( M->getElementBySId("k") == NULL );
+  fail_unless( M->getElementBySId("u") == NULL );
+
+  r->setId("J1");
+  fail_unless( M->getElementBySId("J0") == NULL );
+  fail_unless( M->getElementBySId("J1") == r );
+
+  M->getSpecies(1)->setId("J0");
+  fail_unless( M->getElementBySId("J0") == M->getSpecies(1) );
+  fail_unless( D->getElementBySId("J0") == M->getSpecies(1) );
+}
+END_TEST
+
+
+START_TEST (test_ListOfIdIndex_getElementBySIdNested)
+{
+  Reaction* r = M->createReaction();
+  r->setId("J0");
+  SpeciesReference* sr = r->createReactant();
+  sr->setSpecies("s0");
+  sr->setId("sr0");
+  r->createKineticLaw()->createLocalParameter()->setId("s1");
+  Parameter* p = M->createParameter();
+  p->setId("u");
+  M->createUnitDefinition()->setId("u");
+  Event* e = M->createEvent();
+  e->setId("E0");
+  EventAssignment* ea = e->createEventAssignment();
+  ea->setVariable("u");
+
+  /* enough look-ups to use the index */
+  for (unsigned int n = 0; n < 10; ++n)
+  {
+    fail_unless( M->getElementBySId("sr0") == sr );
+    fail_unless( M->getElementBySId("u") == p );
+    fail_unless( M->getElementBySId("s1") == M->getSpecies(1) );
+    fail_unless( M->getElementBySId("J0") == r );
+    fail_unless( M->getElementBySId("nothing") == NULL );
+  }
+
+  /* removing or renaming elements updates the index */
+  delete r->removeReactant(0);
+  delete M->removeParameter("u");
+  for (unsigned int n = 0; n < 10; ++n)
+  {
+    fail_unless( M->getElementBySId("sr0") == NULL );
+    fail_unless( M->getElementBySId("u") == NULL );
+  }
+
+  M->getSpecies(2)->setId("sr0");
+  for (unsigned int n = 0; n < 10; ++n)
+  {
+    fail_unless( M->getElementBySId("sr0") == M->getSpecies(2) );
+    fail_unless( M->getElementBySId("s2") == NULL );
+  }
+
+  r->unsetKineticLaw();
+  fail_unless( M->getElementBySId("E0") == e );
+}
+END_TEST
+
+
+#ifdef LIBSBML_HAVE_THREADS
+static void
+lookUpConcurrently (Model* m, unsigned int num, bool* ok)
+{
+  const Model* cm = m;
+  *ok = true;
+
+  for (unsigned int n = 0; n < num; ++n)
+  {
+    std::ostringstream id;
+    id << "s" << n;
+    const Species* s = cm->getSpecies(n);
+    if (cm->getSpecies(id.str()) != s ||
+        cm->getListOfSpecies()->get(id.str()) != s ||
+        m->getElementBySId(id.str()) != s)
+    {
+      *ok = false;
+    }
+  }
+}
+
+
+START_TEST (test_ListOfIdIndex_concurrentLookups)
+{
+  const unsigned int numSpecies = 2000;
+  const unsigned int numThreads = 8;
+
+  for (unsigned int n = M->getNumSpecies(); n < numSpecies; ++n)
+  {
+    std::ostringstream id;
+    id << "s" << n;
+    M->createSpecies()->setId(id.str());
+  }
+
+  /* the indexes are built by whichever thread looks first */
+  bool ok[numThreads];
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < numThreads; ++t)
+  {
+    threads.push_back(std::thread(lookUpConcurrently, M, numSpecies, &ok[t]));
+  }
+  for (unsigned int t = 0; t < numThreads; ++t)
+  {
+    threads[t].join();
+    fail_unless( ok[t] );
+  }
+}
+END_TEST
+#endif
+
+
+Suite *
+create_suite_ListOfIdIndex (void)
+{
+  Suite *suite = suite_create("ListOfIdIndex");
+  TCase *tcase = tcase_create("ListOfIdIndex");
+
+  tcase_add_checked_fixture( tcase,
+                             ListOfIdIndexTest_setup,
+                             ListOfIdIndexTest_teardown );
+
+  tcase_add_test( tcase, test_ListOfIdIndex_get              );
+  tcase_add_test( tcase, test_ListOfIdIndex_setId            );
+  tcase_add_test( tcase, test_ListOfIdIndex_duplicates       );
+  tcase_add_test( tcase, test_ListOfIdIndex_remove           );
+  tcase_add_test( tcase, test_ListOfIdIndex_removeOutlivesList );
+  tcase_add_test( tcase, test_ListOfIdIndex_directChanges    );
+  tcase_add_test( tcase, test_ListOfIdIndex_read             );
+  tcase_add_test( tcase, test_ListOfIdIndex_assign           );
+  tcase_add_test( tcase, test_ListOfIdIndex_getElementBySId  );
+  tcase_add_test( tcase, test_ListOfIdIndex_getElementBySIdNested );
+#ifdef LIBSBML_HAVE_THREADS
+  tcase_add_test( tcase, test_ListOfIdIndex_concurrentLookups );
+#endif
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+END_C_DECLS
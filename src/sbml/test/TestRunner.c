@@ -167,6 +167,8 @@ Suite *create_suite_SBMLValidatorAPI              (void);
 
 Suite *create_suite_GetMultipleObjects            (void);
 Suite *create_suite_RemoveFromParent              (void);
+Suite *create_suite_ListOfIdIndex                 (void);
+Suite *create_suite_SBMLComponentHandler          (void);
 Suite *create_suite_RenameIDs                     (void);
 Suite *create_suite_SBMLTransforms                (void);
 
@@ -224,6 +226,8 @@ main (int argc, char* argv[])
   srunner_add_suite( runner, create_suite_RenameIDs                     () );
   srunner_add_suite( runner, create_suite_RemoveFromParent              () );
   srunner_add_suite( runner, create_suite_GetMultipleObjects            () );
+  srunner_add_suite( runner, create_suite_ListOfIdIndex                 () );
+  srunner_add_suite( runner, create_suite_SBMLComponentHandler          () );
   srunner_add_suite( runner, create_suite_WriteSBML                     () );
   srunner_add_suite( runner, create_suite_WriteL3SBML                   () );
   srunner_add_suite( runner, create_suite_WriteL3V2SBML                 () );
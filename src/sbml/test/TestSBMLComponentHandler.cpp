@@ -0,0 +1,203 @@
+/**
+ * @file    TestSBMLComponentHandler.cpp
+ * @brief   Unit tests for reading the components of a model one at a time
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sbml/common/common.h>
+#include <sbml/common/extern.h>
+#include <sbml/SBMLTypes.h>
+#include <sbml/SBMLReader.h>
+
+#include <check.h>
+
+#include <string>
+#include <vector>
+
+LIBSBML_CPP_NAMESPACE_USE
+
+BEGIN_C_DECLS
+
+extern char *TestDataDirectory;
+
+
+/*
+ * Keeps the ids of the species and reactions it is given.
+ */
+class SpeciesAndReactionsHandler : public SBMLComponentHandler
+{
+public:
+
+  SpeciesAndReactionsHandler(int stopAfter = -1)
+    : mStopAfter(stopAfter)
+    , mConnected(true)
+  {
+  }
+
+  virtual bool handles(const SBase* component)
+  {
+    return component->getTypeCode() == SBML_SPECIES
+      || component->getTypeCode() == SBML_REACTION;
+  }
+
+  virtual int handle(SBase* component)
+  {
+    mIds.push_back(component->getId());
+
+    if (component->getModel() == NULL
+      || component->getSBMLDocument() == NULL
+      || component->getSBMLDocument()->getModel() != component->getModel())
+    {
+      mConnected = false;
+    }
+
+    if (component->getTypeCode() == SBML_REACTION
+      && static_cast<Reaction*>(component)->getNumReactants() != 1)
+    {
+      mConnected = false;
+    }
+
+    if ((int)mIds.size() == mStopAfter)
+    {
+      return LIBSBML_OPERATION_FAILED;
+    }
+
+    return LIBSBML_OPERATION_SUCCESS;
+  }
+
+  std::vector<std::string> mIds;
+  int mStopAfter;
+  bool mConnected;
+};
+
+
+static std::string
+getFilename()
+{
+  char *filename = safe_strcat(TestDataDirectory, "l3v2-all.xml");
+  std::string result(filename);
+  safe_free(filename);
+
+  return result;
+}
+
+
+START_TEST (test_SBMLComponentHandler_file)
+{
+  SpeciesAndReactionsHandler handler;
+  SBMLReader reader;
+
+  SBMLDocument* d = reader.readSBMLFromFile(getFilename(), handler);
+  SBMLDocument* full = reader.readSBMLFromFile(getFilename());
+
+  fail_unless(handler.mConnected);
+  fail_unless(handler.mIds.size() == 3);
+  fail_unless(handler.mIds[0] == "X0");
+  fail_unless(handler.mIds[1] == "P");
+  fail_unless(handler.mIds[2] == "in");
+
+  // the handled components are not kept, the others are
+  Model* m = d->getModel();
+  fail_unless(m != NULL);
+  fail_unless(m->getNumSpecies() == 0);
+  fail_unless(m->getNumReactions() == 0);
+  fail_unless(m->getSpecies("X0") == NULL);
+  fail_unless(m->getNumCompartments() == full->getModel()->getNumCompartments());
+  fail_unless(m->getNumParameters() == full->getModel()->getNumParameters());
+  fail_unless(m->getNumEvents() == full->getModel()->getNumEvents());
+
+  // the lists emptied are not reported as errors
+  fail_unless(d->getNumErrors() == full->getNumErrors());
+
+  delete full;
+  delete d;
+}
+END_TEST
+
+
+START_TEST (test_SBMLComponentHandler_string)
+{
+  const char* xml =
+    "<sbml xmlns=\"http://www.sbml.org/sbml/level2/version4\" level=\"2\" version=\"4\">"
+    "  <model>"
+    "    <listOfCompartments>"
+    "      <compartment id=\"c\"/>"
+    "    </listOfCompartments>"
+    "    <listOfSpecies>"
+    "      <species id=\"s1\" compartment=\"c\"/>"
+    "    </listOfSpecies>"
+    "    <listOfParameters>"
+    "      <parameter id=\"p\"/>"
+    "    </listOfParameters>"
+    "  </model>"
+    "</sbml>";
+
+  SpeciesAndReactionsHandler handler;
+  SBMLReader reader;
+
+  SBMLDocument* d = reader.readSBMLFromString(xml, handler);
+
+  fail_unless(handler.mIds.size() == 1);
+  fail_unless(handler.mIds[0] == "s1");
+  fail_unless(d->getNumErrors() == 0);
+  fail_unless(d->getModel()->getNumSpecies() == 0);
+  fail_unless(d->getModel()->getNumCompartments() == 1);
+  fail_unless(d->getModel()->getNumParameters() == 1);
+
+  // the document can still be read in full
+  delete d;
+  d = reader.readSBMLFromString(xml);
+  fail_unless(d->getModel()->getNumSpecies() == 1);
+
+  delete d;
+}
+END_TEST
+
+
+START_TEST (test_SBMLComponentHandler_stop)
+{
+  SpeciesAndReactionsHandler handler(1);
+  SBMLReader reader;
+
+  SBMLDocument* d = reader.readSBMLFromFile(getFilename(), handler);
+
+  fail_unless(handler.mIds.size() == 1);
+  fail_unless(handler.mIds[0] == "X0");
+  fail_unless(d->getErrorLog()->contains(OperationInterrupted));
+  fail_unless(d->getModel()->getNumReactions() == 0);
+
+  delete d;
+}
+END_TEST
+
+
+Suite *
+create_suite_SBMLComponentHandler (void)
+{
+  Suite *suite = suite_create("SBMLComponentHandler");
+  TCase *tcase = tcase_create("SBMLComponentHandler");
+
+  tcase_add_test( tcase, test_SBMLComponentHandler_file   );
+  tcase_add_test( tcase, test_SBMLComponentHandler_string );
+  tcase_add_test( tcase, test_SBMLComponentHandler_stop   );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+END_C_DECLS
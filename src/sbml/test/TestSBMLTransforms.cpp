@@ -40,11 +40,21 @@
 #include <sbml/SBMLTypes.h>
 
 #include <sbml/SBMLTransforms.h>
+#include <sbml/CompiledMath.h>
 #include <sbml/conversion/ConversionProperties.h>
 
+#include <sbml/util/ThreadSupport.h>
+
 #include <check.h>
 
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef LIBSBML_HAVE_THREADS
+#include <thread>
+#endif
 
 LIBSBML_CPP_NAMESPACE_USE
 
@@ -949,6 +959,321 @@ START_TEST(test_SBMLTransforms_evaluateAST_L2SpeciesReference)
 }
 END_TEST
 
+static Model*
+createModelWithParameter (SBMLDocument& doc, double value)
+{
+  Model* m = doc.createModel();
+  Parameter* p = m->createParameter();
+  p->setId("p");
+  p->setValue(value);
+  p->setConstant(true);
+
+  p = m->createParameter();
+  p->setId("q");
+  p->setConstant(false);
+
+  InitialAssignment* ia = m->createInitialAssignment();
+  ia->setSymbol("q");
+  ASTNode* math = SBML_parseL3Formula("max(p, 0) + 1");
+  ia->setMath(math);
+  delete math;
+
+  return m;
+}
+
+START_TEST(test_SBMLTransforms_evaluationContext)
+{
+  SBMLDocument doc1(3, 2);
+  SBMLDocument doc2(3, 2);
+  Model* m1 = createModelWithParameter(doc1, 1);
+  Model* m2 = createModelWithParameter(doc2, 2);
+
+  ASTNode* node = SBML_parseL3Formula("p * 2 + q");
+
+  EvaluationContext context1(m1);
+  EvaluationContext context2(m2);
+  fail_unless(context1.getModel() == m1);
+  fail_unless(util_isEqual(context1.evaluate(node), 4));
+  fail_unless(util_isEqual(context2.evaluate(node), 7));
+
+  // the static functions do not reuse the values of another model
+  fail_unless(util_isEqual(SBMLTransforms::evaluateASTNode(node, m1), 4));
+  fail_unless(util_isEqual(SBMLTransforms::evaluateASTNode(node, m2), 7));
+  SBMLTransforms::clearComponentValues();
+
+  EvaluationContext copy(context1);
+  copy.setValue("p", 10);
+  fail_unless(util_isEqual(copy.evaluate(node), 31));
+  fail_unless(util_isEqual(context1.evaluate(node), 4));
+
+  // values that are not owned are copied before being changed
+  EvaluationContext::IdValueMap values = context1.getValues();
+  EvaluationContext borrowed(values, m1);
+  borrowed.setValue("q", 0);
+  fail_unless(util_isEqual(borrowed.evaluate(node), 2));
+  fail_unless(util_isNaN(values["q"].first));
+
+  context1.clear();
+  fail_unless(context1.getModel() == NULL);
+  fail_unless(util_isNaN(context1.evaluate(node)));
+
+  delete node;
+}
+END_TEST
+
+START_TEST(test_SBMLTransforms_evaluationContextFD)
+{
+  std::string filename(TestDataDirectory);
+  filename += "multiple-functions.xml";
+
+  SBMLDocument* d = readSBMLFromFile(filename.c_str());
+  fail_unless(d->getModel() != NULL);
+
+  ASTNode* node = SBML_parseL3Formula("f(2, g(4, cos(0)))");
+
+  EvaluationContext context;
+  fail_unless(util_isNaN(context.evaluate(node)));
+
+  context.setListOfFunctionDefinitions(
+                           d->getModel()->getListOfFunctionDefinitions());
+  fail_unless(util_isEqual(context.evaluate(node), 8));
+
+  delete node;
+  delete d;
+}
+END_TEST
+
+#ifdef LIBSBML_HAVE_THREADS
+static void
+evaluateConcurrently (const Model* m, const std::vector<ASTNode*>* nodes,
+                      const std::vector<double>* expected, bool* ok)
+{
+  EvaluationContext context(m);
+  *ok = true;
+
+  for (size_t n = 0; n < nodes->size(); ++n)
+  {
+    if (!util_isEqual(context.evaluate((*nodes)[n]), (*expected)[n]))
+    {
+      *ok = false;
+    }
+  }
+}
+
+START_TEST(test_SBMLTransforms_evaluationContextThreads)
+{
+  const unsigned int numReactions = 200;
+  const unsigned int numThreads = 8;
+
+  SBMLDocument doc(3, 2);
+  Model* m = doc.createModel();
+
+  FunctionDefinition* fd = m->createFunctionDefinition();
+  fd->setId("f");
+  ASTNode* math = SBML_parseL3Formula("lambda(x, 2 * x)");
+  fd->setMath(math);
+  delete math;
+
+  std::vector<ASTNode*> nodes;
+  std::vector<double> expected;
+  for (unsigned int n = 0; n < numReactions; ++n)
+  {
+    std::ostringstream k, r, formula;
+    k << "k" << n;
+    r << "R" << n;
+
+    Parameter* p = m->createParameter();
+    p->setId(k.str());
+    p->setValue(n);
+    p->setConstant(true);
+
+    Reaction* rn = m->createReaction();
+    rn->setId(r.str());
+    rn->setReversible(false);
+    math = SBML_parseL3Formula((k.str() + " + 1").c_str());
+    rn->createKineticLaw()->setMath(math);
+    delete math;
+
+    formula << "f(" << k.str() << ") + " << r.str();
+    nodes.push_back(SBML_parseL3Formula(formula.str().c_str()));
+    expected.push_back(3.0 * n + 1);
+  }
+
+  /* every thread sets up its own context from the shared model; the ids
+   * are looked up (and indexed) by whichever thread gets there first */
+  bool ok[numThreads];
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < numThreads; ++t)
+  {
+    threads.push_back(std::thread(evaluateConcurrently, m, &nodes,
+                                  &expected, &ok[t]));
+  }
+  for (unsigned int t = 0; t < numThreads; ++t)
+  {
+    threads[t].join();
+    fail_unless(ok[t]);
+  }
+
+  for (size_t n = 0; n < nodes.size(); ++n)
+  {
+    delete nodes[n];
+  }
+}
+END_TEST
+#endif
+
+static bool
+equalOrBothNaN (double a, double b)
+{
+  return (util_isNaN(a) && util_isNaN(b)) || util_isEqual(a, b);
+}
+
+START_TEST(test_SBMLTransforms_compiledMath)
+{
+  const char* formulas[] = {
+    "2.5 + 6.1", "-4.3", "9.2 - 4.3 - 1", "2 * 3 * 4", "1/5", "pow(2, 3)",
+    "abs(-9.456)", "ceil(9.456)", "floor(2.04567)", "exp(2.0)", "ln(2.0)",
+    "log10(100.0)", "sqrt(2.0)", "root(3, 8)", "factorial(5)",
+    "sin(2.1) + cos(4.1) + tan(0.5)", "sec(2.1) + csc(4.1) + cot(0.5)",
+    "sinh(2.1) + cosh(4.1) + tanh(0.5)", "sech(2.1) + csch(4.1) + coth(0.5)",
+    "asin(0.5) + acos(0.5) + atan(0.5)", "arccot(0.5) + arcsec(2) + arccsc(2)",
+    "arcsinh(0.5) + arccosh(1.5) + arctanh(0.5)",
+    "arccoth(2) + arcsech(0.5) + arccsch(2)",
+    "and(true, false) + or(false, true) + xor(true, true) + not(false)",
+    "eq(2, 2, 3) + geq(3, 2, 2) + gt(3, 2) + leq(1, 1) + lt(2, 1) + neq(1, 2)",
+    "piecewise(1, gt(2, 3), 4, lt(2, 3))", "piecewise(1, false, 7)",
+    "piecewise(1, true, 2, true)", "piecewise(1, false)",
+    "exponentiale * pi + avogadro + time", "p * 2 + q", "q / unknown",
+    "max(p, 2) + rem(7, p + 2)",
+    NULL
+  };
+
+  SBMLDocument doc(3, 2);
+  Model* m = createModelWithParameter(doc, 3);
+  EvaluationContext context(m);
+
+  for (unsigned int n = 0; formulas[n] != NULL; ++n)
+  {
+    ASTNode* node = SBML_parseL3Formula(formulas[n]);
+    fail_unless(node != NULL);
+
+    CompiledMath compiled(node, context);
+    fail_unless(compiled.getNumVariables() == 0);
+    fail_unless(equalOrBothNaN(compiled.evaluate(), context.evaluate(node)));
+
+    // the math does not depend on anything that varies
+    fail_unless(compiled.getNumInstructions() == 1);
+    fail_unless(!compiled.usesTreeEvaluation());
+
+    delete node;
+  }
+
+  CompiledMath none(NULL, m);
+  fail_unless(util_isNaN(none.evaluate()));
+}
+END_TEST
+
+
+START_TEST(test_SBMLTransforms_compiledMathVariables)
+{
+  SBMLDocument doc(3, 2);
+  Model* m = createModelWithParameter(doc, 3);
+
+  FunctionDefinition* fd = m->createFunctionDefinition();
+  fd->setId("f");
+  ASTNode* math = SBML_parseL3Formula("lambda(x, y, x * y + 1)");
+  fd->setMath(math);
+  delete math;
+
+  std::vector<std::string> variables;
+  variables.push_back("x");
+  variables.push_back("p");
+
+  ASTNode* node = SBML_parseL3Formula(
+          "f(x, 2) + q * piecewise(x, gt(x, p), p) - ln(exp(2)) * sin(0)");
+  CompiledMath compiled(node, m, variables);
+
+  fail_unless(compiled.getNumVariables() == 2);
+  fail_unless(compiled.getVariable(1) == "p");
+  fail_unless(compiled.getVariable(2).empty());
+  fail_unless(compiled.getVariableIndex("x") == 0);
+  fail_unless(compiled.getVariableIndex("q") == -1);
+  fail_unless(util_isNaN(compiled.evaluate()));
+
+  // q is set by its initial assignment to max(p, 0) + 1, which is left
+  // to the tree evaluator
+  fail_unless(compiled.usesTreeEvaluation());
+  double values[2] = { 5, 3 };
+  fail_unless(util_isEqual(compiled.evaluate(values), 11 + 4 * 5));
+  values[0] = -1;
+  values[1] = 2;
+  fail_unless(util_isEqual(compiled.evaluate(values), -1 + 3 * 2));
+
+  // the same results with the tree evaluator
+  EvaluationContext context(m);
+  context.setValue("x", -1);
+  context.setValue("p", 2);
+  fail_unless(util_isEqual(context.evaluate(node), -1 + 3 * 2));
+
+  const unsigned int numSets = 150;
+  std::vector<double> columns(2 * numSets);
+  std::vector<double> results(numSets);
+  for (unsigned int i = 0; i < numSets; ++i)
+  {
+    columns[i] = i * 0.5;
+    columns[numSets + i] = 10.0 - i;
+  }
+  compiled.evaluate(&columns[0], numSets, &results[0]);
+  for (unsigned int i = 0; i < numSets; ++i)
+  {
+    double set[2] = { columns[i], columns[numSets + i] };
+    fail_unless(results[i] == compiled.evaluate(set));
+  }
+
+  CompiledMath copy(compiled);
+  fail_unless(copy.getNumInstructions() == compiled.getNumInstructions());
+  fail_unless(util_isEqual(copy.evaluate(values), -1 + 3 * 2));
+
+  delete node;
+}
+END_TEST
+
+
+START_TEST(test_SBMLTransforms_compiledMathTree)
+{
+  SBMLDocument doc(3, 2);
+  Model* m = createModelWithParameter(doc, 3);
+
+  std::vector<std::string> variables;
+  variables.push_back("p");
+
+  // max is l3v2extendedmath, and q depends on p
+  ASTNode* node = SBML_parseL3Formula("2 * max(q, 5) + p");
+  CompiledMath compiled(node, m, variables);
+  fail_unless(compiled.usesTreeEvaluation());
+
+  double value = 1;
+  fail_unless(util_isEqual(compiled.evaluate(&value), 2 * 5 + 1));
+  value = 7;
+  fail_unless(util_isEqual(compiled.evaluate(&value), 2 * 8 + 7));
+
+  double values[3] = { 1, 7, -3 };
+  double results[3];
+  compiled.evaluate(values, 3, results);
+  fail_unless(util_isEqual(results[0], 2 * 5 + 1));
+  fail_unless(util_isEqual(results[1], 2 * 8 + 7));
+  fail_unless(util_isEqual(results[2], 2 * 5 - 3));
+
+  CompiledMath assigned(NULL, m);
+  assigned = compiled;
+  fail_unless(assigned.usesTreeEvaluation());
+  fail_unless(util_isEqual(assigned.evaluate(&value), 2 * 8 + 7));
+
+  delete node;
+}
+END_TEST
+
+
 Suite *
 create_suite_SBMLTransforms (void)
 {
@@ -967,6 +1292,14 @@ create_suite_SBMLTransforms (void)
   tcase_add_test(tcase, test_SBMLTransforms_evaluateL3V2ASTWithModel);
   tcase_add_test(tcase, test_SBMLTransforms_L3V2AssignmentNoMath);
   tcase_add_test(tcase, test_SBMLTransforms_StoichiometryMath);
+  tcase_add_test(tcase, test_SBMLTransforms_evaluationContext);
+  tcase_add_test(tcase, test_SBMLTransforms_evaluationContextFD);
+  tcase_add_test(tcase, test_SBMLTransforms_compiledMath);
+  tcase_add_test(tcase, test_SBMLTransforms_compiledMathVariables);
+  tcase_add_test(tcase, test_SBMLTransforms_compiledMathTree);
+#ifdef LIBSBML_HAVE_THREADS
+  tcase_add_test(tcase, test_SBMLTransforms_evaluationContextThreads);
+#endif
 
 
   suite_add_tcase(suite, tcase);
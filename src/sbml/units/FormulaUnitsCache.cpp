@@ -0,0 +1,483 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    FormulaUnitsCache.cpp
+ * @brief   Keeps the units derived from math between populations of a model
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <cstdio>
+#include <set>
+
+#include <sbml/Model.h>
+#include <sbml/units/FormulaUnitsCache.h>
+#include <sbml/units/FormulaUnitsData.h>
+#include <sbml/units/UnitFormulaFormatter.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+static void
+appendNumber(std::string& key, double value)
+{
+  char buffer[32];
+  sprintf(buffer, "%.17g;", value);
+  key += buffer;
+}
+
+
+static void
+appendNumber(std::string& key, long value)
+{
+  char buffer[32];
+  sprintf(buffer, "%ld;", value);
+  key += buffer;
+}
+
+
+static void
+appendUnits(std::string& key, const UnitDefinition * ud)
+{
+  if (ud == NULL)
+  {
+    key += '-';
+    return;
+  }
+
+  key += '[';
+  for (unsigned int n = 0; n < ud->getNumUnits(); ++n)
+  {
+    const Unit * u = ud->getUnit(n);
+    appendNumber(key, (long)(u->getKind()));
+    appendNumber(key, u->getExponentAsDouble());
+    appendNumber(key, (long)(u->getScale()));
+    appendNumber(key, u->getMultiplier());
+    appendNumber(key, u->getOffset());
+  }
+  key += ']';
+}
+
+
+static void
+appendFormulaUnits(std::string& key, const FormulaUnitsData * fud)
+{
+  if (fud == NULL)
+  {
+    key += '-';
+    return;
+  }
+
+  key += fud->getContainsUndeclaredUnits() ? 'u' : 'd';
+  key += fud->getCanIgnoreUndeclaredUnits() ? 'i' : 'n';
+  appendUnits(key, fud->getUnitDefinition());
+}
+
+
+/*
+ * Appends everything about the math that its units may depend on.
+ */
+static void
+appendMath(std::string& key, const ASTNode * node)
+{
+  if (node == NULL)
+  {
+    key += '~';
+    return;
+  }
+
+  key += '(';
+  appendNumber(key, (long)(node->getType()));
+
+  if (node->isInteger())
+  {
+    appendNumber(key, node->getInteger());
+  }
+  else if (node->isRational())
+  {
+    appendNumber(key, node->getNumerator());
+    appendNumber(key, node->getDenominator());
+  }
+  else if (node->isReal())
+  {
+    appendNumber(key, node->getReal());
+  }
+  else if (node->getName() != NULL)
+  {
+    key += node->getName();
+    key += ';';
+  }
+
+  if (node->getType() == AST_CSYMBOL_FUNCTION)
+  {
+    key += node->getDefinitionURLString();
+    key += ';';
+  }
+
+  if (node->isSetUnits())
+  {
+    key += node->getUnits();
+    key += ';';
+  }
+
+  for (unsigned int n = 0; n < node->getNumChildren(); ++n)
+  {
+    appendMath(key, node->getChild(n));
+  }
+  key += ')';
+}
+
+
+static void
+collectNames(const ASTNode * node, std::set<std::string>& names)
+{
+  if (node == NULL)
+  {
+    return;
+  }
+
+  if (node->isName() && node->getName() != NULL)
+  {
+    names.insert(node->getName());
+  }
+
+  for (unsigned int n = 0; n < node->getNumChildren(); ++n)
+  {
+    collectNames(node->getChild(n), names);
+  }
+}
+
+
+FormulaUnitsCache::FormulaUnitsCache()
+  : mEntries()
+  , mModelKey()
+  , mPass(0)
+  , mNumReused(0)
+  , mModel(NULL)
+  , mIdentifierKeys()
+{
+}
+
+
+FormulaUnitsCache::FormulaUnitsCache(const FormulaUnitsCache& orig)
+  : mEntries()
+  , mModelKey(orig.mModelKey)
+  , mPass(orig.mPass)
+  , mNumReused(0)
+  , mModel(NULL)
+  , mIdentifierKeys()
+{
+  copyEntries(orig);
+}
+
+
+FormulaUnitsCache&
+FormulaUnitsCache::operator=(const FormulaUnitsCache& rhs)
+{
+  if (&rhs != this)
+  {
+    clear();
+    mModelKey = rhs.mModelKey;
+    mPass = rhs.mPass;
+    copyEntries(rhs);
+  }
+
+  return *this;
+}
+
+
+FormulaUnitsCache::~FormulaUnitsCache()
+{
+  clear();
+}
+
+
+void
+FormulaUnitsCache::begin(const Model * m)
+{
+  mModel = m;
+  mIdentifierKeys.clear();
+  mNumReused = 0;
+  ++mPass;
+
+  std::string key = getModelKey();
+  if (key != mModelKey)
+  {
+    clear();
+    mModelKey = key;
+  }
+}
+
+
+void
+FormulaUnitsCache::setUnits(FormulaUnitsData * fud, const ASTNode * math,
+                            UnitFormulaFormatter * formatter,
+                            const KineticLaw * kl, int reactNo)
+{
+  std::string key;
+
+  if (kl != NULL)
+  {
+    // names in the math of a kinetic law may be local parameters
+    key += 'K';
+    for (unsigned int n = 0; n < kl->getNumParameters(); ++n)
+    {
+      key += kl->getParameter(n)->getId();
+      key += ':';
+      key += kl->getParameter(n)->getUnits();
+      key += ';';
+    }
+  }
+  key += 'M';
+  appendMath(key, math);
+
+  Entry *& entry = mEntries[key];
+
+  if (entry != NULL && entry->pass != mPass && !isCurrent(*entry))
+  {
+    delete entry->unitDefinition;
+    delete entry;
+    entry = NULL;
+  }
+
+  if (entry != NULL)
+  {
+    ++mNumReused;
+  }
+  else
+  {
+    entry = new Entry();
+    entry->unitDefinition = NULL;
+    entry->containsUndeclaredUnits = false;
+    entry->canIgnoreUndeclaredUnits = true;
+    entry->containsInconsistency = false;
+
+    if (math != NULL)
+    {
+      formatter->resetFlags();
+      entry->unitDefinition = formatter->getUnitDefinition(math, kl != NULL,
+                                                           reactNo);
+      entry->containsUndeclaredUnits = formatter->getContainsUndeclaredUnits();
+      entry->canIgnoreUndeclaredUnits = formatter->canIgnoreUndeclaredUnits();
+      entry->containsInconsistency = formatter->getContainsInconsistentUnits();
+    }
+
+    std::set<std::string> names;
+    collectNames(math, names);
+    for (std::set<std::string>::const_iterator it = names.begin();
+         it != names.end(); ++it)
+    {
+      entry->identifiers.push_back(make_pair(*it, getIdentifierKey(*it)));
+    }
+  }
+  entry->pass = mPass;
+
+  fud->setUnitDefinition(entry->unitDefinition != NULL ?
+                         entry->unitDefinition->clone() : NULL);
+  if (math != NULL)
+  {
+    fud->setContainsParametersWithUndeclaredUnits
+                                          (entry->containsUndeclaredUnits);
+    fud->setCanIgnoreUndeclaredUnits(entry->canIgnoreUndeclaredUnits);
+    if (kl == NULL)
+    {
+      fud->setContainsInconsistency(entry->containsInconsistency);
+    }
+  }
+}
+
+
+void
+FormulaUnitsCache::end()
+{
+  EntryMap::iterator it = mEntries.begin();
+  while (it != mEntries.end())
+  {
+    if (it->second->pass != mPass)
+    {
+      delete it->second->unitDefinition;
+      delete it->second;
+      mEntries.erase(it++);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  mModel = NULL;
+  mIdentifierKeys.clear();
+}
+
+
+void
+FormulaUnitsCache::clear()
+{
+  for (EntryMap::iterator it = mEntries.begin(); it != mEntries.end(); ++it)
+  {
+    delete it->second->unitDefinition;
+    delete it->second;
+  }
+  mEntries.clear();
+  mModelKey.clear();
+}
+
+
+unsigned int
+FormulaUnitsCache::getNumEntries() const
+{
+  return (unsigned int)mEntries.size();
+}
+
+
+unsigned int
+FormulaUnitsCache::getNumReused() const
+{
+  return mNumReused;
+}
+
+
+bool
+FormulaUnitsCache::isCurrent(const Entry& entry)
+{
+  for (size_t n = 0; n < entry.identifiers.size(); ++n)
+  {
+    if (getIdentifierKey(entry.identifiers[n].first)
+                                        != entry.identifiers[n].second)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+/*
+ * Describes the units of the component with the given id, as seen by
+ * UnitFormulaFormatter::getUnitDefinition().
+ */
+const std::string&
+FormulaUnitsCache::getIdentifierKey(const std::string& id)
+{
+  std::map<std::string, std::string>::iterator it = mIdentifierKeys.find(id);
+  if (it != mIdentifierKeys.end())
+  {
+    return it->second;
+  }
+
+  std::string key;
+
+  if (mModel->getCompartment(id) != NULL)
+  {
+    key += 'c';
+    appendFormulaUnits(key,
+      mModel->getFormulaUnitsData(id, SBML_COMPARTMENT));
+  }
+  else if (mModel->getSpecies(id) != NULL)
+  {
+    const Species * s = mModel->getSpecies(id);
+    key += 's';
+    key += s->getCompartment() + ';' + s->getSubstanceUnits() + ';'
+         + s->getSpatialSizeUnits() + ';';
+    key += s->getHasOnlySubstanceUnits() ? 'h' : 'c';
+    appendFormulaUnits(key, mModel->getFormulaUnitsData(id, SBML_SPECIES));
+  }
+  else if (mModel->getParameter(id) != NULL)
+  {
+    key += 'p';
+    appendFormulaUnits(key, mModel->getFormulaUnitsData(id, SBML_PARAMETER));
+  }
+  else if (mModel->getLevel() > 2 && mModel->getSpeciesReference(id) != NULL)
+  {
+    key += 'r';
+  }
+  else if (mModel->getReaction(id) != NULL)
+  {
+    key += 'x';
+  }
+
+  return mIdentifierKeys[id] = key;
+}
+
+
+/*
+ * Describes what applies to the units of all math of the model.
+ */
+std::string
+FormulaUnitsCache::getModelKey() const
+{
+  std::string key;
+
+  appendNumber(key, (long)(mModel->getLevel()));
+  appendNumber(key, (long)(mModel->getVersion()));
+
+  key += mModel->getSubstanceUnits() + ';' + mModel->getTimeUnits() + ';'
+       + mModel->getVolumeUnits() + ';' + mModel->getAreaUnits() + ';'
+       + mModel->getLengthUnits() + ';' + mModel->getExtentUnits() + ';';
+
+  // the model-wide units data come first
+  for (unsigned int n = 0; n < mModel->getNumFormulaUnitsData(); ++n)
+  {
+    const FormulaUnitsData * fud = mModel->getFormulaUnitsData(n);
+    int typecode = fud->getComponentTypecode();
+    if (typecode != SBML_MODEL && typecode != SBML_UNKNOWN)
+    {
+      break;
+    }
+
+    key += fud->getUnitReferenceId();
+    appendFormulaUnits(key, fud);
+  }
+
+  for (unsigned int n = 0; n < mModel->getNumUnitDefinitions(); ++n)
+  {
+    const UnitDefinition * ud = mModel->getUnitDefinition(n);
+    key += ud->getId();
+    appendUnits(key, ud);
+  }
+
+  for (unsigned int n = 0; n < mModel->getNumFunctionDefinitions(); ++n)
+  {
+    const FunctionDefinition * fd = mModel->getFunctionDefinition(n);
+    key += fd->getId();
+    appendMath(key, fd->getMath());
+  }
+
+  return key;
+}
+
+
+void
+FormulaUnitsCache::copyEntries(const FormulaUnitsCache& orig)
+{
+  for (EntryMap::const_iterator it = orig.mEntries.begin();
+       it != orig.mEntries.end(); ++it)
+  {
+    Entry * entry = new Entry(*(it->second));
+    if (entry->unitDefinition != NULL)
+    {
+      entry->unitDefinition = entry->unitDefinition->clone();
+    }
+    mEntries[it->first] = entry;
+  }
+}
+
+LIBSBML_CPP_NAMESPACE_END
+
+/** @endcond */
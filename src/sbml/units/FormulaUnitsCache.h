@@ -0,0 +1,154 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    FormulaUnitsCache.h
+ * @brief   Keeps the units derived from math between populations of a model
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class FormulaUnitsCache
+ * @sbmlbrief{core} Units derived from math, kept between calls to
+ * Model::populateListFormulaUnitsData().
+ *
+ * Deriving the units of the math of a model is the expensive part of
+ * Model::populateListFormulaUnitsData().  A FormulaUnitsCache owned by the
+ * Model remembers, for each piece of math, the units derived for it along
+ * with what they were derived from:
+ *
+ * @li the math itself (its structure, names, numbers and units);
+ * @li for each identifier it mentions, the units of the component of
+ * that name (or the local parameters, for the math of a KineticLaw);
+ * @li the things that apply to all math: the SBML Level and Version,
+ * the model-wide units, the unit definitions and the function definitions.
+ *
+ * Units are reused only if all of these are unchanged, so that editing an
+ * element only recomputes the units of the math that may depend on it.
+ */
+
+#ifndef FormulaUnitsCache_h
+#define FormulaUnitsCache_h
+
+
+#include <sbml/common/extern.h>
+
+#ifdef __cplusplus
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+class ASTNode;
+class FormulaUnitsData;
+class KineticLaw;
+class Model;
+class UnitDefinition;
+class UnitFormulaFormatter;
+
+class LIBSBML_EXTERN FormulaUnitsCache
+{
+public:
+
+  FormulaUnitsCache();
+
+  FormulaUnitsCache(const FormulaUnitsCache& orig);
+
+  FormulaUnitsCache& operator=(const FormulaUnitsCache& rhs);
+
+  ~FormulaUnitsCache();
+
+
+  /**
+   * Starts using the cache for the given model, whose model-wide,
+   * compartment, species and parameter units data must be populated.
+   * Everything is forgotten if what applies to all math has changed.
+   */
+  void begin(const Model * m);
+
+
+  /**
+   * Sets the units (and related flags) of the given math on the
+   * FormulaUnitsData, derived with the UnitFormulaFormatter unless
+   * they are known.
+   *
+   * @param kl the KineticLaw the math belongs to, or @c NULL.
+   * @param reactNo the index of the Reaction of @p kl.
+   */
+  void setUnits(FormulaUnitsData * fud, const ASTNode * math,
+                UnitFormulaFormatter * formatter,
+                const KineticLaw * kl = NULL, int reactNo = -1);
+
+
+  /**
+   * Stops using the cache for the current model, forgetting the units of
+   * math that was not seen since begin().
+   */
+  void end();
+
+
+  void clear();
+
+
+  unsigned int getNumEntries() const;
+
+
+  /**
+   * @return the number of times units were reused since begin().
+   */
+  unsigned int getNumReused() const;
+
+
+private:
+
+  struct Entry
+  {
+    UnitDefinition * unitDefinition;
+    bool containsUndeclaredUnits;
+    bool canIgnoreUndeclaredUnits;
+    bool containsInconsistency;
+    std::vector< std::pair<std::string, std::string> > identifiers;
+    unsigned long pass;
+  };
+
+  typedef std::map<std::string, Entry*> EntryMap;
+
+  bool isCurrent(const Entry& entry);
+
+  const std::string& getIdentifierKey(const std::string& id);
+
+  std::string getModelKey() const;
+
+  void copyEntries(const FormulaUnitsCache& orig);
+
+  EntryMap mEntries;
+  std::string mModelKey;
+  unsigned long mPass;
+  unsigned int mNumReused;
+
+  /* valid between begin() and end() */
+  const Model * mModel;
+  std::map<std::string, std::string> mIdentifierKeys;
+};
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* FormulaUnitsCache_h */
+
+/** @endcond */
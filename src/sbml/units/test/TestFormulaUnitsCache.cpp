@@ -0,0 +1,278 @@
+/**
+ * \file    TestFormulaUnitsCache.cpp
+ * \brief   tests the units kept between populations of the units data
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sbml/common/common.h>
+#include <sbml/common/extern.h>
+
+#include <sbml/SBMLReader.h>
+#include <sbml/SBMLTypes.h>
+
+#include <sbml/SBMLDocument.h>
+#include <sbml/Model.h>
+#include <sbml/math/FormulaParser.h>
+
+#include <sbml/units/FormulaUnitsCache.h>
+#include <sbml/units/FormulaUnitsData.h>
+
+#include <check.h>
+
+LIBSBML_CPP_NAMESPACE_USE
+
+extern char *TestDataDirectory;
+
+static Model *m;
+static SBMLDocument* d;
+
+/*
+ * the units data of m after an edit must be those of a model that was
+ * edited before its units data were populated for the first time
+ */
+
+
+void
+FormulaUnitsCache_setup (void)
+{
+  char *filename = safe_strcat(TestDataDirectory, "formula.xml");
+
+  d = readSBML(filename);
+  m = d->getModel();
+
+  m->populateListFormulaUnitsData();
+
+  safe_free(filename);
+}
+
+
+void
+FormulaUnitsCache_teardown (void)
+{
+  delete d;
+}
+
+
+static bool
+sameUnitsData(const Model* m1, const Model* m2)
+{
+  if (m1->getNumFormulaUnitsData() != m2->getNumFormulaUnitsData())
+  {
+    return false;
+  }
+
+  for (unsigned int n = 0; n < m1->getNumFormulaUnitsData(); ++n)
+  {
+    const FormulaUnitsData* fud1 = m1->getFormulaUnitsData(n);
+    const FormulaUnitsData* fud2 = m2->getFormulaUnitsData(n);
+
+    if (fud1->getUnitReferenceId() != fud2->getUnitReferenceId()
+      || fud1->getComponentTypecode() != fud2->getComponentTypecode()
+      || fud1->getContainsUndeclaredUnits()
+                                    != fud2->getContainsUndeclaredUnits()
+      || fud1->getCanIgnoreUndeclaredUnits()
+                                    != fud2->getCanIgnoreUndeclaredUnits()
+      || fud1->getContainsInconsistency() != fud2->getContainsInconsistency())
+    {
+      return false;
+    }
+
+    const UnitDefinition* ud1 = fud1->getUnitDefinition();
+    const UnitDefinition* ud2 = fud2->getUnitDefinition();
+    if ((ud1 == NULL) != (ud2 == NULL)
+      || (ud1 != NULL && !UnitDefinition::areIdentical(ud1, ud2)))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+static SBMLDocument*
+readAgain()
+{
+  char *filename = safe_strcat(TestDataDirectory, "formula.xml");
+  SBMLDocument* doc = readSBML(filename);
+  safe_free(filename);
+
+  return doc;
+}
+
+
+CK_CPPSTART
+
+START_TEST (test_FormulaUnitsCache_reuse)
+{
+  const FormulaUnitsCache* cache = m->getFormulaUnitsCache();
+  fail_unless(cache != NULL);
+  fail_unless(cache->getNumEntries() == 9);
+  fail_unless(cache->getNumReused() == 0);
+
+  Model copy(*m);
+
+  m->populateListFormulaUnitsData();
+  fail_unless(cache->getNumEntries() == 9);
+  fail_unless(cache->getNumReused() == 9);
+  fail_unless(sameUnitsData(m, &copy));
+
+  // the cache is copied with the model
+  copy.populateListFormulaUnitsData();
+  fail_unless(copy.getFormulaUnitsCache()->getNumReused() == 9);
+  fail_unless(sameUnitsData(m, &copy));
+}
+END_TEST
+
+
+START_TEST (test_FormulaUnitsCache_parameterUnits)
+{
+  m->getParameter("k2")->setUnits("second");
+  m->populateListFormulaUnitsData();
+
+  // k2 appears in the rate rule, the algebraic rule and the
+  // stoichiometryMath; the kinetic law uses a local k2
+  fail_unless(m->getFormulaUnitsCache()->getNumReused() == 6);
+
+  SBMLDocument* edited = readAgain();
+  edited->getModel()->getParameter("k2")->setUnits("second");
+  edited->getModel()->populateListFormulaUnitsData();
+  fail_unless(sameUnitsData(m, edited->getModel()));
+  delete edited;
+
+  const FormulaUnitsData* fud =
+                      m->getFormulaUnitsData("x1", SBML_STOICHIOMETRY_MATH);
+  const UnitDefinition* ud = fud->getUnitDefinition();
+  fail_unless(ud->getNumUnits() == 1);
+  fail_unless(ud->getUnit(0)->getKind() == UNIT_KIND_SECOND);
+  fail_unless(ud->getUnit(0)->getExponent() == -1);
+}
+END_TEST
+
+
+START_TEST (test_FormulaUnitsCache_localParameterUnits)
+{
+  m->getReaction(0)->getKineticLaw()->getParameter("k_1")->setUnits("litre");
+  m->populateListFormulaUnitsData();
+  fail_unless(m->getFormulaUnitsCache()->getNumReused() == 8);
+
+  const FormulaUnitsData* fud =
+                      m->getFormulaUnitsData("R", SBML_KINETIC_LAW);
+  const UnitDefinition* ud = fud->getUnitDefinition();
+  fail_unless(ud->getNumUnits() == 2);
+  fail_unless(ud->getUnit(1)->getKind() == UNIT_KIND_LITRE);
+  fail_unless(ud->getUnit(1)->getExponent() == -1);
+}
+END_TEST
+
+
+START_TEST (test_FormulaUnitsCache_math)
+{
+  ASTNode* math = SBML_parseFormula("y * cell");
+  m->getInitialAssignment(0)->setMath(math);
+  delete math;
+
+  m->populateListFormulaUnitsData();
+  fail_unless(m->getFormulaUnitsCache()->getNumReused() == 8);
+  fail_unless(m->getFormulaUnitsCache()->getNumEntries() == 9);
+
+  const FormulaUnitsData* fud =
+                 m->getFormulaUnitsData("z2", SBML_INITIAL_ASSIGNMENT);
+  fail_unless(fud->getUnitDefinition()->getNumUnits() == 2);
+
+  // math can also be changed in place
+  m->getInitialAssignment(0)->getMath()->getChild(1)->setName("k1");
+  m->populateListFormulaUnitsData();
+  fail_unless(m->getFormulaUnitsCache()->getNumReused() == 8);
+
+  SBMLDocument* edited = readAgain();
+  math = SBML_parseFormula("y * k1");
+  edited->getModel()->getInitialAssignment(0)->setMath(math);
+  delete math;
+  edited->getModel()->populateListFormulaUnitsData();
+  fail_unless(sameUnitsData(m, edited->getModel()));
+  delete edited;
+}
+END_TEST
+
+
+START_TEST (test_FormulaUnitsCache_modelWide)
+{
+  m->getUnitDefinition("m_per_sec")->getUnit(1)->setExponent(-2);
+  m->populateListFormulaUnitsData();
+  fail_unless(m->getFormulaUnitsCache()->getNumReused() == 0);
+
+  SBMLDocument* edited = readAgain();
+  edited->getModel()->getUnitDefinition("m_per_sec")->getUnit(1)
+                                                    ->setExponent(-2);
+  edited->getModel()->populateListFormulaUnitsData();
+  fail_unless(sameUnitsData(m, edited->getModel()));
+  delete edited;
+
+  m->getFunctionDefinition(0)->getMath()->getChild(2)->setType(AST_TIMES);
+  m->populateListFormulaUnitsData();
+  fail_unless(m->getFormulaUnitsCache()->getNumReused() == 0);
+}
+END_TEST
+
+
+START_TEST (test_FormulaUnitsCache_newIdentifier)
+{
+  // a name that did not refer to anything now does
+  ASTNode* math = SBML_parseFormula("y * unknown");
+  m->getInitialAssignment(0)->setMath(math);
+  delete math;
+  m->populateListFormulaUnitsData();
+
+  const FormulaUnitsData* fud =
+                 m->getFormulaUnitsData("z2", SBML_INITIAL_ASSIGNMENT);
+  fail_unless(fud->getContainsUndeclaredUnits() == true);
+
+  Parameter* p = m->createParameter();
+  p->setId("unknown");
+  p->setUnits("second");
+  m->populateListFormulaUnitsData();
+
+  fud = m->getFormulaUnitsData("z2", SBML_INITIAL_ASSIGNMENT);
+  fail_unless(fud->getContainsUndeclaredUnits() == false);
+  fail_unless(fud->getUnitDefinition()->getNumUnits() == 2);
+}
+END_TEST
+
+
+Suite *
+create_suite_FormulaUnitsCache (void)
+{
+  Suite *suite = suite_create("FormulaUnitsCache");
+  TCase *tcase = tcase_create("FormulaUnitsCache");
+
+  tcase_add_checked_fixture(tcase,
+                            FormulaUnitsCache_setup,
+                            FormulaUnitsCache_teardown);
+
+  tcase_add_test(tcase, test_FormulaUnitsCache_reuse );
+  tcase_add_test(tcase, test_FormulaUnitsCache_parameterUnits );
+  tcase_add_test(tcase, test_FormulaUnitsCache_localParameterUnits );
+  tcase_add_test(tcase, test_FormulaUnitsCache_math );
+  tcase_add_test(tcase, test_FormulaUnitsCache_modelWide );
+  tcase_add_test(tcase, test_FormulaUnitsCache_newIdentifier );
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND
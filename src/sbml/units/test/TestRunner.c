@@ -64,6 +64,7 @@ Suite *create_suite_UnitFormulaFormatter2 (void);
 Suite *create_suite_UnitFormulaFormatter3 (void);
 Suite *create_suite_FormulaUnitsData (void);
 Suite *create_suite_FormulaUnitsDataMap(void);
+Suite *create_suite_FormulaUnitsCache (void);
 Suite *create_suite_DerivedUnitDefinition (void);
 Suite *create_suite_CalcUnitDefinition (void);
 Suite *create_suite_DerivedUnitDefinitionUndefined (void);
@@ -121,6 +122,7 @@ main (void)
   srunner_add_suite( runner, create_suite_UnitFormulaFormatter1() );
   srunner_add_suite( runner, create_suite_FormulaUnitsData() );
   srunner_add_suite( runner, create_suite_FormulaUnitsDataMap());
+  srunner_add_suite( runner, create_suite_FormulaUnitsCache());
   srunner_add_suite( runner, create_suite_DerivedUnitDefinition() );
   srunner_add_suite( runner, create_suite_UnitFormulaFormatter2() );
   srunner_add_suite( runner, create_suite_CalcUnitDefinition() );
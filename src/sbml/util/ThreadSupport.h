@@ -0,0 +1,230 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    ThreadSupport.h
+ * @brief   Minimal mutex, atomic counter and task runner
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * Some look-up structures (e.g., the identifier index of ListOf) are built
+ * on first use from const methods.  Reading a model from several threads
+ * is allowed as long as no thread modifies it, so the first use has to be
+ * synchronized.  With a C++11 compiler the classes below wrap std::mutex and
+ * std::atomic; otherwise they compile to nothing and libSBML keeps its old
+ * single-threaded guarantees.  Likewise, runTasks() only uses several
+ * threads when they are supported.
+ */
+
+#ifndef ThreadSupport_h
+#define ThreadSupport_h
+
+#include <sbml/common/extern.h>
+
+#ifdef __cplusplus
+
+#if !defined(LIBSBML_HAVE_THREADS) && \
+    (__cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900))
+#define LIBSBML_HAVE_THREADS 1
+#endif
+
+#include <vector>
+
+#ifdef LIBSBML_HAVE_THREADS
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#endif
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+/*
+ * A non-recursive mutex.
+ */
+class Mutex
+{
+public:
+  Mutex() {}
+
+#ifdef LIBSBML_HAVE_THREADS
+  void lock()   { mMutex.lock();   }
+  void unlock() { mMutex.unlock(); }
+
+private:
+  std::mutex mMutex;
+#else
+  void lock()   {}
+  void unlock() {}
+#endif
+
+private:
+  Mutex(const Mutex&);
+  Mutex& operator=(const Mutex&);
+};
+
+
+/*
+ * Holds a Mutex for the lifetime of the object.
+ */
+class MutexLock
+{
+public:
+  explicit MutexLock(Mutex& mutex) : mMutex(mutex) { mMutex.lock(); }
+  ~MutexLock() { mMutex.unlock(); }
+
+private:
+  MutexLock(const MutexLock&);
+  MutexLock& operator=(const MutexLock&);
+
+  Mutex& mMutex;
+};
+
+
+/*
+ * An unsigned long whose stores are published to the threads that load it
+ * (release/acquire ordering).
+ */
+class AtomicRevision
+{
+public:
+  explicit AtomicRevision(unsigned long value = 0) : mValue(value) {}
+
+#ifdef LIBSBML_HAVE_THREADS
+  unsigned long load() const
+  { return mValue.load(std::memory_order_acquire); }
+  void store(unsigned long value)
+  { mValue.store(value, std::memory_order_release); }
+
+private:
+  std::atomic<unsigned long> mValue;
+#else
+  unsigned long load() const        { return mValue; }
+  void store(unsigned long value)   { mValue = value; }
+
+private:
+  unsigned long mValue;
+#endif
+
+private:
+  AtomicRevision(const AtomicRevision&);
+  AtomicRevision& operator=(const AtomicRevision&);
+};
+
+
+#ifdef LIBSBML_HAVE_THREADS
+/*
+ * Hands out the tasks given to runTasks() to the threads asking for work.
+ */
+template <class Task>
+class TaskQueue
+{
+public:
+  explicit TaskQueue(const std::vector<Task*>& tasks)
+    : mTasks(tasks), mNext(0), mError() {}
+
+  void work()
+  {
+    for (size_t n = mNext++; n < mTasks.size(); n = mNext++)
+    {
+      try
+      {
+        mTasks[n]->run();
+      }
+      catch (...)
+      {
+        MutexLock lock(mMutex);
+        if (!mError)
+        {
+          mError = std::current_exception();
+        }
+      }
+    }
+  }
+
+  void rethrow()
+  {
+    if (mError)
+    {
+      std::rethrow_exception(mError);
+    }
+  }
+
+private:
+  TaskQueue(const TaskQueue&);
+  TaskQueue& operator=(const TaskQueue&);
+
+  const std::vector<Task*>& mTasks;
+  std::atomic<size_t> mNext;
+  std::exception_ptr mError;
+  Mutex mMutex;
+};
+#endif
+
+
+/*
+ * Calls run() on each of the tasks, using up to numThreads threads (the
+ * calling one included).  Without thread support, or if fewer than two
+ * threads are asked for, the tasks are run in order by the calling
+ * thread.  An exception thrown by a task is passed on once all tasks
+ * are done.
+ */
+template <class Task>
+void
+runTasks(const std::vector<Task*>& tasks, unsigned int numThreads)
+{
+#ifdef LIBSBML_HAVE_THREADS
+  if (numThreads > 1 && tasks.size() > 1)
+  {
+    TaskQueue<Task> queue(tasks);
+    std::vector<std::thread> threads;
+
+    for (size_t n = 1; n < numThreads && n < tasks.size(); ++n)
+    {
+      try
+      {
+        threads.push_back(std::thread(&TaskQueue<Task>::work, &queue));
+      }
+      catch (std::system_error&)
+      {
+        // carry on with the threads we have
+        break;
+      }
+    }
+
+    queue.work();
+    for (size_t n = 0; n < threads.size(); ++n)
+    {
+      threads[n].join();
+    }
+    queue.rethrow();
+    return;
+  }
+#endif
+
+  for (size_t n = 0; n < tasks.size(); ++n)
+  {
+    tasks[n]->run();
+  }
+}
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* ThreadSupport_h */
+
+/** @endcond */
@@ -65,6 +65,7 @@
 #include <sbml/AlgebraicRule.h>
 #include <sbml/AssignmentRule.h>
 #include <sbml/RateRule.h>
+#include <sbml/util/ThreadSupport.h>
 
 
 
@@ -77,6 +78,7 @@ SBMLInternalValidator::SBMLInternalValidator()
   : SBMLValidator()
   , mApplicableValidators(0)
   , mApplicableValidatorsForConversion(0)
+  , mNumThreads(1)
 {
 
 }
@@ -86,6 +88,7 @@ SBMLInternalValidator::SBMLInternalValidator(const SBMLInternalValidator& orig)
   : SBMLValidator(orig)
   , mApplicableValidators(orig.mApplicableValidators)
   , mApplicableValidatorsForConversion(orig.mApplicableValidatorsForConversion)
+  , mNumThreads(orig.mNumThreads)
 {
 }
 
@@ -299,6 +302,95 @@ SBMLInternalValidator::setConsistencyChecksForConversion(SBMLErrorCategory_t cat
   }
 
 }
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Runs validators on copies of a document, several at a time.  The
+ * validators must not share the document, since some of them store
+ * information (e.g., the units of formulas) on the model they validate.
+ */
+class ConcurrentValidation
+{
+public:
+  explicit ConcurrentValidation(const SBMLDocument* doc)
+    : mDocument(doc), mTasks(), mNumRun(0) {}
+
+  ~ConcurrentValidation()
+  {
+    for (size_t n = 0; n < mTasks.size(); ++n)
+    {
+      delete mTasks[n];
+    }
+  }
+
+  void add(Validator& validator)
+  {
+    validator.init();
+    mTasks.push_back(new Task(validator, mDocument));
+  }
+
+  /* runs the validators added since the last call */
+  void run(unsigned int numThreads)
+  {
+    std::vector<Task*> pending(mTasks.begin() + mNumRun, mTasks.end());
+    runTasks(pending, numThreads);
+    mNumRun = mTasks.size();
+  }
+
+  bool hasRun(const Validator& validator) const
+  {
+    for (size_t n = 0; n < mNumRun; ++n)
+    {
+      if (&mTasks[n]->mValidator == &validator)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  struct Task
+  {
+    Task(Validator& validator, const SBMLDocument* doc)
+      : mValidator(validator), mDocument(doc) {}
+
+    void run()
+    {
+      SBMLDocument* copy = mDocument->clone();
+      mValidator.validate(*copy);
+      delete copy;
+    }
+
+    Validator& mValidator;
+    const SBMLDocument* mDocument;
+  };
+
+  const SBMLDocument* mDocument;
+  std::vector<Task*> mTasks;
+  size_t mNumRun;
+};
+
+
+/*
+ * Runs the validator on the document, unless it has already been run.
+ *
+ * @return the number of failures.
+ */
+static unsigned int
+runValidator(Validator& validator, const SBMLDocument& doc,
+             const ConcurrentValidation& concurrent)
+{
+  if (concurrent.hasRun(validator))
+  {
+    return (unsigned int)validator.getFailures().size();
+  }
+
+  validator.init();
+  return validator.validate(doc);
+}
+/** @endcond */
+
+
 /*
  * Performs a set of semantic consistency checks on the document.  Query
  * the results by calling getNumErrors() and getError().
@@ -366,12 +458,30 @@ SBMLInternalValidator::checkConsistency (bool writeDocument)
     return 0;
   }
 
+  IdentifierConsistencyValidator id_validator;
+  ConsistencyValidator validator;
+  SBOConsistencyValidator sbo_validator;
+  MathMLConsistencyValidator math_validator;
+  UnitConsistencyValidator unit_validator;
+  OverdeterminedValidator over_validator;
+  ModelingPracticeValidator practice_validator;
+
+  /* with several threads, the first four validators run at the same time,
+   * and the others once they passed (unit checks may crash on invalid
+   * math); the failures are then handled in the same order as otherwise */
+  ConcurrentValidation concurrent(doc);
+  if (mNumThreads > 1)
+  {
+    if (id)   concurrent.add(id_validator);
+    if (sbml) concurrent.add(validator);
+    if (sbo)  concurrent.add(sbo_validator);
+    if (math) concurrent.add(math_validator);
+    concurrent.run(mNumThreads);
+  }
 
   if (id)
   {
-    IdentifierConsistencyValidator id_validator;
-    id_validator.init();
-    nerrors = id_validator.validate(*doc);
+    nerrors = runValidator(id_validator, *doc, concurrent);
     if (nerrors > 0) 
     {
       unsigned int origNum = log->getNumErrors();
@@ -426,9 +536,7 @@ SBMLInternalValidator::checkConsistency (bool writeDocument)
 
   if (sbml)
   {
-    ConsistencyValidator validator;
-    validator.init();
-    nerrors = validator.validate(*doc);
+    nerrors = runValidator(validator, *doc, concurrent);
     total_errors += nerrors;
     if (nerrors > 0) 
     {
@@ -445,9 +553,7 @@ SBMLInternalValidator::checkConsistency (bool writeDocument)
 
   if (sbo)
   {
-    SBOConsistencyValidator sbo_validator;
-    sbo_validator.init();
-    nerrors = sbo_validator.validate(*doc);
+    nerrors = runValidator(sbo_validator, *doc, concurrent);
     total_errors += nerrors;
     if (nerrors > 0) 
     {
@@ -464,9 +570,7 @@ SBMLInternalValidator::checkConsistency (bool writeDocument)
 
   if (math)
   {
-    MathMLConsistencyValidator math_validator;
-    math_validator.init();
-    nerrors = math_validator.validate(*doc);
+    nerrors = runValidator(math_validator, *doc, concurrent);
     total_errors += nerrors;
     if (nerrors > 0) 
     {
@@ -480,12 +584,17 @@ SBMLInternalValidator::checkConsistency (bool writeDocument)
     }
   }
 
+  if (mNumThreads > 1)
+  {
+    if (units)    concurrent.add(unit_validator);
+    if (over)     concurrent.add(over_validator);
+    if (practice) concurrent.add(practice_validator);
+    concurrent.run(mNumThreads);
+  }
 
   if (units)
   {
-    UnitConsistencyValidator unit_validator;
-    unit_validator.init();
-    nerrors = unit_validator.validate(*doc);
+    nerrors = runValidator(unit_validator, *doc, concurrent);
     total_errors += nerrors;
     if (nerrors > 0) 
     {
@@ -504,9 +613,7 @@ SBMLInternalValidator::checkConsistency (bool writeDocument)
    * changed this as would have bailed */
   if (over)
   {
-    OverdeterminedValidator over_validator;
-    over_validator.init();
-    nerrors = over_validator.validate(*doc);
+    nerrors = runValidator(over_validator, *doc, concurrent);
     total_errors += nerrors;
     if (nerrors > 0) 
     {
@@ -523,9 +630,7 @@ SBMLInternalValidator::checkConsistency (bool writeDocument)
 
   if (practice)
   {
-    ModelingPracticeValidator practice_validator;
-    practice_validator.init();
-    nerrors = practice_validator.validate(*doc);
+    nerrors = runValidator(practice_validator, *doc, concurrent);
     if (nerrors > 0) 
     {
       unsigned int errorsAdded = 0;
@@ -805,6 +910,20 @@ SBMLInternalValidator::setConversionValidators(unsigned char appl)
   mApplicableValidatorsForConversion = appl;
 }
 
+
+void
+SBMLInternalValidator::setNumThreads(unsigned int numThreads)
+{
+  mNumThreads = numThreads;
+}
+
+
+unsigned int
+SBMLInternalValidator::getNumThreads() const
+{
+  return mNumThreads;
+}
+
 unsigned int 
   SBMLInternalValidator::validate()
 {
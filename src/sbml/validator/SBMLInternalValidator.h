@@ -460,6 +460,28 @@ public:
   void setConversionValidators(unsigned char appl);
 
 
+  /**
+   * Sets the number of threads used by checkConsistency().
+   *
+   * With more than one thread, the identifier, general, SBO and MathML
+   * validators run at the same time, followed by the units,
+   * overdetermined and modeling practice validators.  Each of them works
+   * on its own copy of the document.  The failures are reported in the
+   * same order, and with the same early exits, as with a single thread.
+   *
+   * @param numThreads the number of threads; with the default value of
+   * @c 1, the validators run one after the other on the document itself.
+   * Without thread support in the compiler, the value is ignored.
+   */
+  void setNumThreads(unsigned int numThreads);
+
+
+  /**
+   * @return the number of threads used by checkConsistency().
+   */
+  unsigned int getNumThreads() const;
+
+
   /**
    * Constructor.
    */
@@ -504,6 +526,7 @@ protected:
   /** @cond doxygenLibsbmlInternal */
   unsigned char mApplicableValidators;
   unsigned char mApplicableValidatorsForConversion;
+  unsigned int mNumThreads;
 
   /** @endcond */
 